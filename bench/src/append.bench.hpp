@@ -0,0 +1,47 @@
+/*
+    Adding monotonic, nearly sorted and random streams of keys: add (with the
+    cached ends of the tree), insert_hint at end() and std::multiset with the
+    same hint as baseline.
+*/
+#pragma once
+
+#include <set>
+#include <vector>
+
+#include "bench.hpp"
+#include "..\..\include\avl.hpp"
+
+
+inline void bench_append_stream(std::ostream& out, const std::string& input, const std::vector<int>& keys)
+{
+    size_t n { keys.size() };
+    size_t size { 0 };
+    double ns { bench::measure(n, [&]{
+        tree::AVL<int> search_tree;
+        for ( int key : keys ) search_tree.add(key);
+        size += search_tree.root() != nullptr;
+    }) };
+    out << bench::Result{ "AVL", "add", input, n, ns } << '\n';
+
+    ns = bench::measure(n, [&]{
+        tree::AVL<int> search_tree;
+        for ( int key : keys ) search_tree.insert_hint(search_tree.end(), key);
+        size += search_tree.root() != nullptr;
+    });
+    out << bench::Result{ "AVL", "insert_hint_end", input, n, ns } << '\n';
+
+    ns = bench::measure(n, [&]{
+        std::multiset<int> baseline;
+        for ( int key : keys ) baseline.insert(baseline.end(), key);
+        size += baseline.size();
+    });
+    out << bench::Result{ "std::multiset", "insert_hint_end", input, n, ns } << '\n';
+    bench::do_not_optimize(size);
+}
+
+void bench_append(std::ostream& out, size_t n)
+{
+    bench_append_stream(out, "sorted", bench::sorted_keys(n));
+    bench_append_stream(out, "nearly_sorted", bench::nearly_sorted_keys(n));
+    bench_append_stream(out, "random", bench::random_keys(n));
+}
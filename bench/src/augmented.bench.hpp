@@ -0,0 +1,47 @@
+/*
+    Range sums: aggregate of AugmentedAVL against scanning AVL with in_order.
+    Ranges cover 1 % of keys.
+*/
+#pragma once
+
+#include "bench.hpp"
+#include "..\..\include\augmented.hpp"
+
+
+void bench_augmented(std::ostream& out, size_t n)
+{
+    auto keys { bench::random_keys(n) };
+    auto starts { bench::random_keys(1000, 7) };
+    const int width { static_cast<int>(std::max<size_t>(1, n / 100)) };
+    long long total { 0 };
+
+    tree::AVL<int> search_tree;
+    double ns { bench::measure(n, [&]{ for ( int key : keys ) search_tree.add(key); }) };
+    out << bench::Result{ "AVL", "add", "random", n, ns } << '\n';
+    ns = bench::measure(starts.size(), [&]{
+        for ( int start : starts )
+        {
+            int lo { static_cast<int>(start * (n / 1000)) };
+            tree::in_order(search_tree, [&](int key)
+            {
+                if ( key > lo + width ) return tree::Visit::stop;
+                if ( key >= lo ) total += key;
+                return tree::Visit::proceed;
+            });
+        }
+    });
+    out << bench::Result{ "AVL", "range_sum_scan", "random", n, ns } << '\n';
+
+    tree::AugmentedAVL<int, tree::SumOf<long long>> augmented;
+    ns = bench::measure(n, [&]{ for ( int key : keys ) augmented.add(key); });
+    out << bench::Result{ "AugmentedAVL", "add", "random", n, ns } << '\n';
+    ns = bench::measure(starts.size(), [&]{
+        for ( int start : starts )
+        {
+            int lo { static_cast<int>(start * (n / 1000)) };
+            total += augmented.aggregate(lo, lo + width);
+        }
+    });
+    out << bench::Result{ "AugmentedAVL", "range_sum_aggregate", "random", n, ns } << '\n';
+    bench::do_not_optimize(total);
+}
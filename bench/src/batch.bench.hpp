@@ -0,0 +1,85 @@
+/*
+    Batched search with prefetching, and search with sorted probes, against a
+    loop of single searches. Nearest-key queries on AVL and on the static
+    layouts.
+
+    Batched search is interesting for trees larger than the last-level cache,
+    i.e. n of 1M and more. Sorted probes are n / 16 sorted random keys.
+*/
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "bench.hpp"
+#include "..\..\include\avl.hpp"
+#include "..\..\include\array.hpp"
+#include "..\..\include\simd.hpp"
+
+
+template<typename Tree>
+void bench_batch_tree(std::ostream& out, const std::string& name, size_t n)
+{
+    Tree search_tree;
+    for ( int key : bench::random_keys(n) ) search_tree.add(key);
+    auto probes { bench::random_keys(n, 7) };
+
+    size_t found { 0 };
+    double ns { bench::measure(n, [&]{
+        for ( int key : probes ) found += search_tree.search(key).has_value();
+    }) };
+    out << bench::Result{ name, "search", "random", n, ns } << '\n';
+
+    for ( size_t batch : { 64, 512 } )
+    {
+        std::vector<std::optional<int>> results(batch);
+        ns = bench::measure(n, [&]{
+            for ( size_t i {0}; i < probes.size(); i += batch )
+            {
+                size_t count { std::min(batch, probes.size() - i) };
+                search_tree.search_batch(std::span<const int>(probes.data() + i, count), results);
+                for ( size_t j {0}; j < count; ++j ) found += results[j].has_value();
+            }
+        });
+        out << bench::Result{ name, "search_batch_" + std::to_string(batch), "random", n, ns } << '\n';
+    }
+
+    std::vector<int> sorted(probes.begin(), probes.begin() + std::max<size_t>(1, n / 16));
+    std::sort(sorted.begin(), sorted.end());
+    ns = bench::measure(sorted.size(), [&]{
+        for ( int key : sorted ) found += search_tree.search(key).has_value();
+    });
+    out << bench::Result{ name, "search", "sorted_probes", sorted.size(), ns } << '\n';
+    ns = bench::measure(sorted.size(), [&]{ found += search_tree.intersect_keys(sorted).size(); });
+    out << bench::Result{ name, "intersect_keys", "sorted_probes", sorted.size(), ns } << '\n';
+    bench::do_not_optimize(found);
+}
+
+// Keys are even, probes odd, so every query falls between two keys.
+inline void bench_nearest(std::ostream& out, size_t n)
+{
+    tree::AVL<int> search_tree;
+    for ( int key : bench::random_keys(n) ) search_tree.add(2 * key);
+    auto probes { bench::random_keys(n, 7) };
+    for ( int& probe : probes ) probe = 2 * probe + 1;
+    long long total { 0 };
+
+    double ns { bench::measure(n, [&]{ for ( int key : probes ) total += *search_tree.nearest(key); }) };
+    out << bench::Result{ "AVL", "nearest", "random", n, ns } << '\n';
+
+    tree::Eytzinger<int> array_tree { search_tree };
+    ns = bench::measure(n, [&]{ for ( int key : probes ) total += *array_tree.nearest(key); });
+    out << bench::Result{ "Eytzinger", "nearest", "random", n, ns } << '\n';
+
+    tree::SimdSearchTree<int> simd_tree { search_tree };
+    ns = bench::measure(n, [&]{ for ( int key : probes ) total += *simd_tree.nearest(key); });
+    out << bench::Result{ "SimdSearchTree", "nearest", "random", n, ns } << '\n';
+    bench::do_not_optimize(total);
+}
+
+void bench_batch(std::ostream& out, size_t n)
+{
+    bench_batch_tree<tree::BST<int>>(out, "BST", n);
+    bench_batch_tree<tree::AVL<int>>(out, "AVL", n);
+    bench_nearest(out, n);
+}
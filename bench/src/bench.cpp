@@ -0,0 +1,73 @@
+/*
+    Benchmarks of Binary Tree and its variants.
+
+    Usage: bench [max_n] [suite]
+
+    Every suite runs for n = 1K, 10K, 100K, ... up to max_n (default 1M, largest
+    sensible value is 100M). Optional suite runs only benchmarks of that name:
+    core, split, simd, huffman, batch, append, multiset, augmented, interval, sequence, sharded, durable, snapshot, paged, succinct, loader or indexed. Results go to bench_output.txt.
+*/
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <functional>
+
+#include "bench.hpp"
+#include "core.bench.hpp"
+#include "split.bench.hpp"
+#include "simd.bench.hpp"
+#include "huffman.bench.hpp"
+#include "batch.bench.hpp"
+#include "append.bench.hpp"
+#include "multiset.bench.hpp"
+#include "augmented.bench.hpp"
+#include "interval.bench.hpp"
+#include "sequence.bench.hpp"
+#include "sharded.bench.hpp"
+#include "durable.bench.hpp"
+#include "snapshot.bench.hpp"
+#include "paged.bench.hpp"
+#include "succinct.bench.hpp"
+#include "loader.bench.hpp"
+#include "indexed.bench.hpp"
+
+int main(int argc, char* argv[])
+{
+    size_t max_n { argc > 1 ? std::stoull(argv[1]) : 1'000'000 };
+    std::string only { argc > 2 ? argv[2] : "" };
+
+    const std::vector<std::pair<std::string, std::function<void(std::ostream&, size_t)>>> suites {
+        { "core",    bench_core    },
+        { "split",   bench_split   },
+        { "simd",    bench_simd    },
+        { "huffman", bench_huffman },
+        { "batch",   bench_batch   },
+        { "append",  bench_append  },
+        { "multiset", bench_multiset },
+        { "augmented", bench_augmented },
+        { "interval", bench_interval },
+        { "sequence", bench_sequence },
+        { "sharded", bench_sharded },
+        { "durable", bench_durable },
+        { "snapshot", bench_snapshot },
+        { "paged", bench_paged },
+        { "succinct", bench_succinct },
+        { "loader", bench_loader },
+        { "indexed", bench_indexed },
+    };
+
+    std::ofstream out { "bench_output.txt" };
+    bench::header(out);
+    for ( size_t n {1'000}; n <= max_n; n *= 10 )
+    {
+        for ( const auto& [name, suite] : suites )
+        {
+            if ( !only.empty() && only != name ) continue;
+            std::cout << "Running " << name << " with n = " << n << std::endl;
+            suite(out, n);
+            out.flush();
+        }
+    }
+
+    return 0;
+}
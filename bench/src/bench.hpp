@@ -0,0 +1,152 @@
+/*
+    Minimal benchmarking helpers.
+
+    Every measurement is reported as one CSV line:
+        structure,operation,input,n,ns_per_op,ops_per_s,rss_kb
+
+    rss_kb is the resident set size of the process right after the measurement.
+*/
+#pragma once
+
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <fstream>
+#include <cmath>
+#include <cstdint>
+
+#if defined(_WIN32)
+    #include <windows.h>
+    #include <psapi.h>
+#endif
+
+
+namespace bench
+{
+
+// Resident set size of this process in KiB, 0 if unknown.
+inline size_t rss_kb()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if ( GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) )
+        return counters.WorkingSetSize / 1024;
+    return 0;
+#else
+    std::ifstream status { "/proc/self/status" };
+    std::string line;
+    while ( std::getline(status, line) )
+        if ( line.rfind("VmRSS:", 0) == 0 ) return std::stoull(line.substr(6));
+    return 0;
+#endif
+}
+
+struct Result
+{
+    std::string structure;
+    std::string operation;
+    std::string input;
+    size_t n;
+    double ns_per_op;
+    size_t rss { rss_kb() };
+};
+
+inline std::ostream& operator<<(std::ostream& os, const Result& result)
+{
+    return os << result.structure << ',' << result.operation << ',' << result.input << ','
+              << result.n << ',' << result.ns_per_op << ','
+              << (result.ns_per_op > 0 ? 1e9 / result.ns_per_op : 0.0) << ','
+              << result.rss;
+}
+
+inline void header(std::ostream& os)
+{
+    os << "structure,operation,input,n,ns_per_op,ops_per_s,rss_kb\n";
+}
+
+// Keep the optimizer from discarding a result.
+template<typename T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+// Run fnc once and return nanoseconds per operation, fnc performing ops operations.
+template<typename F>
+double measure(size_t ops, F fnc)
+{
+    auto start { std::chrono::steady_clock::now() };
+    fnc();
+    auto stop { std::chrono::steady_clock::now() };
+    double ns { std::chrono::duration<double, std::nano>(stop - start).count() };
+    return ops ? ns / ops : ns;
+}
+
+inline std::vector<int> sorted_keys(size_t count)
+{
+    std::vector<int> keys(count);
+    std::iota(keys.begin(), keys.end(), 0);
+    return keys;
+}
+
+// Permutation of 0 .. count - 1.
+inline std::vector<int> random_keys(size_t count, unsigned int seed = 42)
+{
+    std::vector<int> keys { sorted_keys(count) };
+    std::shuffle(keys.begin(), keys.end(), std::mt19937{seed});
+    return keys;
+}
+
+// 0 .. count - 1 in order, except that every key is swapped with one at most distance positions ahead with probability swaps.
+inline std::vector<int> nearly_sorted_keys(size_t count, double swaps = 0.05, size_t distance = 16, unsigned int seed = 42)
+{
+    std::vector<int> keys { sorted_keys(count) };
+    std::mt19937 generator { seed };
+    std::uniform_real_distribution<double> uniform { 0.0, 1.0 };
+    std::uniform_int_distribution<size_t> offset { 1, distance };
+    for ( size_t i {0}; i < count; ++i )
+        if ( uniform(generator) < swaps ) std::swap(keys[i], keys[std::min(count - 1, i + offset(generator))]);
+    return keys;
+}
+
+/*
+    Keys from 0 .. count - 1 drawn with Zipfian distribution (Gray et al.,
+    "Quickly generating billion-record synthetic databases"). Popular keys
+    are scattered over the key space by hashing their rank.
+*/
+inline std::vector<int> zipfian_keys(size_t count, double theta = 0.99, unsigned int seed = 42)
+{
+    double zetan { 0 };
+    for ( size_t i {1}; i <= count; ++i ) zetan += 1.0 / std::pow(static_cast<double>(i), theta);
+    const double zeta2 { 1.0 + std::pow(0.5, theta) };
+    const double alpha { 1.0 / (1.0 - theta) };
+    const double eta { (1.0 - std::pow(2.0 / count, 1.0 - theta)) / (1.0 - zeta2 / zetan) };
+
+    std::mt19937_64 generator { seed };
+    std::uniform_real_distribution<double> uniform { 0.0, 1.0 };
+    std::vector<int> keys;
+    keys.reserve(count);
+    for ( size_t i {0}; i < count; ++i )
+    {
+        double u  { uniform(generator) };
+        double uz { u * zetan };
+        std::uint64_t rank;
+        if      ( uz < 1.0 )   rank = 0;
+        else if ( uz < zeta2 ) rank = 1;
+        else rank = static_cast<std::uint64_t>(count * std::pow(eta * u - eta + 1.0, alpha));
+        std::uint64_t hash { (std::min<std::uint64_t>(rank, count - 1) + 1) * 0x9E3779B97F4A7C15ull };
+        keys.push_back(static_cast<int>((hash >> 17) % count));
+    }
+    return keys;
+}
+
+}  // namespace bench
@@ -0,0 +1,165 @@
+/*
+    Core operations of BST<int>, AVL<int> and AVL<My_Data>, with std::set as a baseline.
+
+    Input kinds:
+        sorted   keys 0 .. n - 1 in ascending order
+        random   permutation of 0 .. n - 1
+        zipfian  n keys from 0 .. n - 1 with Zipfian distribution (many duplicates)
+
+    Plain BST degenerates into a list on sorted and heavily duplicated input. Its
+    recursive member functions would overflow the stack, so those runs are
+    limited to DEGENERATE_LIMIT keys.
+*/
+#pragma once
+
+#include <set>
+#include <fstream>
+#include <cstdio>
+
+#include "bench.hpp"
+#include "..\..\include\avl.hpp"
+#include "..\..\include\types.hpp"
+
+
+constexpr size_t DEGENERATE_LIMIT { 10'000 };
+
+inline My_Data make_my_data(int key)
+{
+    return My_Data(key, "name_" + std::to_string(key));
+}
+
+// Key of given type made from an int key.
+template<typename T>
+T make_key(int key)
+{
+    if constexpr ( std::is_same_v<T, My_Data> ) return make_my_data(key);
+    else return key;
+}
+
+template<typename Tree, typename T>
+void bench_core_tree(std::ostream& out, const std::string& name, const std::string& input,
+                     const std::vector<int>& keys)
+{
+    const size_t n { keys.size() };
+    std::vector<T> data;
+    data.reserve(n);
+    for ( int key : keys ) data.push_back(make_key<T>(key));
+    std::vector<T> probes;
+    probes.reserve(n);
+    for ( int key : bench::random_keys(n, 7) ) probes.push_back(make_key<T>(key));
+
+    size_t found { 0 };
+    {
+        Tree search_tree;
+        double ns { bench::measure(n, [&]{ for ( const auto& item : data ) search_tree.add(item); }) };
+        out << bench::Result{ name, "add", input, n, ns } << '\n';
+
+        ns = bench::measure(n, [&]{ for ( const auto& item : probes ) found += search_tree.search(item).has_value(); });
+        out << bench::Result{ name, "search", input, n, ns } << '\n';
+
+        ns = bench::measure(n, [&]{ for ( auto it {search_tree.begin()}; it != search_tree.end(); ++it ) ++found; });
+        out << bench::Result{ name, "in_order_iterator", input, n, ns } << '\n';
+
+        ns = bench::measure(n, [&]{ for ( const T& item : tree::in_order(search_tree) ) { bench::do_not_optimize(item); ++found; } });
+        out << bench::Result{ name, "in_order_generator", input, n, ns } << '\n';
+
+        ns = bench::measure(n, [&]{ tree::level_order(search_tree, [&](const T&){ ++found; }); });
+        out << bench::Result{ name, "level_order", input, n, ns } << '\n';
+
+        if constexpr ( std::is_same_v<T, int> )
+        {
+            // deserialize reads from a file stream only.
+            const char* path { "bench_tree.tr" };
+            {
+                std::ofstream file { path };
+                ns = bench::measure(n, [&]{ tree::serialize(search_tree.root(), file); });
+            }
+            out << bench::Result{ name, "serialize", input, n, ns } << '\n';
+            {
+                std::ifstream file { path };
+                std::unique_ptr<tree::Node<int>> root;
+                ns = bench::measure(n, [&]{ root = tree::deserialize<int>(file); });
+                found += tree::count_nodes(root);
+            }
+            out << bench::Result{ name, "deserialize", input, n, ns } << '\n';
+            std::remove(path);
+        }
+
+        ns = bench::measure(n, [&]{ for ( const auto& item : probes ) found += search_tree.remove(item); });
+        out << bench::Result{ name, "remove", input, n, ns } << '\n';
+    }
+    {
+        Tree search_tree;
+        for ( const auto& item : data ) search_tree.add(item);
+        double ns { bench::measure(n, [&]{ while ( search_tree.extract_min() ) ++found; }) };
+        out << bench::Result{ name, "extract_min", input, n, ns } << '\n';
+    }
+    {
+        Tree search_tree;
+        for ( const auto& item : data ) search_tree.add(item);
+        double ns { bench::measure(n, [&]{ search_tree.root().reset(); }) };
+        out << bench::Result{ name, "destroy", input, n, ns } << '\n';
+
+        for ( const auto& item : data ) search_tree.add(item);
+        ns = bench::measure(n, [&]{ search_tree.release_async(); });
+        out << bench::Result{ name, "release_async", input, n, ns } << '\n';
+        tree::Reclaimer::instance().drain();
+    }
+    bench::do_not_optimize(found);
+}
+
+template<typename T>
+void bench_core_set(std::ostream& out, const std::string& input, const std::vector<int>& keys)
+{
+    const size_t n { keys.size() };
+    const std::string name { std::is_same_v<T, int> ? "std::multiset<int>" : "std::multiset<My_Data>" };
+    std::vector<T> data;
+    data.reserve(n);
+    for ( int key : keys ) data.push_back(make_key<T>(key));
+    std::vector<T> probes;
+    probes.reserve(n);
+    for ( int key : bench::random_keys(n, 7) ) probes.push_back(make_key<T>(key));
+
+    size_t found { 0 };
+    std::multiset<T> set;
+    double ns { bench::measure(n, [&]{ for ( const auto& item : data ) set.insert(item); }) };
+    out << bench::Result{ name, "add", input, n, ns } << '\n';
+
+    ns = bench::measure(n, [&]{ for ( const auto& item : probes ) found += set.find(item) != set.end(); });
+    out << bench::Result{ name, "search", input, n, ns } << '\n';
+
+    ns = bench::measure(n, [&]{ for ( auto it {set.begin()}; it != set.end(); ++it ) ++found; });
+    out << bench::Result{ name, "in_order_iterator", input, n, ns } << '\n';
+
+    ns = bench::measure(n, [&]{
+        for ( const auto& item : probes )
+        {
+            auto it { set.find(item) };
+            if ( it != set.end() ) { set.erase(it); ++found; }
+        }
+    });
+    out << bench::Result{ name, "remove", input, n, ns } << '\n';
+
+    for ( const auto& item : data ) set.insert(item);
+    ns = bench::measure(n, [&]{ while ( !set.empty() ) { set.erase(set.begin()); ++found; } });
+    out << bench::Result{ name, "extract_min", input, n, ns } << '\n';
+    bench::do_not_optimize(found);
+}
+
+void bench_core(std::ostream& out, size_t n)
+{
+    const std::vector<std::pair<std::string, std::vector<int>>> inputs {
+        { "sorted",  bench::sorted_keys(n)  },
+        { "random",  bench::random_keys(n)  },
+        { "zipfian", bench::zipfian_keys(n) },
+    };
+    for ( const auto& [input, keys] : inputs )
+    {
+        if ( input == "random" || n <= DEGENERATE_LIMIT )
+            bench_core_tree<tree::BST<int>, int>(out, "BST<int>", input, keys);
+        bench_core_tree<tree::AVL<int>, int>(out, "AVL<int>", input, keys);
+        bench_core_tree<tree::AVL<My_Data>, My_Data>(out, "AVL<My_Data>", input, keys);
+        bench_core_set<int>(out, input, keys);
+        bench_core_set<My_Data>(out, input, keys);
+    }
+}
@@ -0,0 +1,55 @@
+/*
+    Cost of the write-ahead log: add throughput of AVL without and with the
+    log for several group sizes, and recovery time from a snapshot of n keys
+    followed by a log of n / 10 operations.
+*/
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include "bench.hpp"
+#include "..\..\include\avl.hpp"
+#include "..\..\include\durable.hpp"
+
+
+// Path in the temporary directory, removing files of previous runs.
+inline std::filesystem::path durable_bench_path_()
+{
+    std::filesystem::path path { std::filesystem::temp_directory_path() / "tree_durable_bench" };
+    for ( const auto& entry : std::filesystem::directory_iterator(path.parent_path()) )
+        if ( entry.path().filename().string().starts_with(path.filename().string() + ".") )
+            std::filesystem::remove(entry.path());
+    return path;
+}
+
+void bench_durable(std::ostream& out, size_t n)
+{
+    auto keys { bench::random_keys(n) };
+    {
+        tree::AVL<int> search_tree;
+        double ns { bench::measure(n, [&]{ for ( int key : keys ) search_tree.add(key); }) };
+        out << bench::Result{ "AVL", "add", "random", n, ns } << '\n';
+    }
+    for ( size_t group : {1, 64, 4096} )
+    {
+        tree::AVL<int> search_tree;
+        tree::Durable durable { search_tree, durable_bench_path_(), group };
+        double ns { bench::measure(n, [&]{ for ( int key : keys ) durable.add(key); durable.commit(); }) };
+        out << bench::Result{ "AVL+WAL", "add", "random_group_" + std::to_string(group), n, ns } << '\n';
+    }
+    {
+        auto path { durable_bench_path_() };
+        {
+            tree::AVL<int> search_tree;
+            tree::Durable durable { search_tree, path, 4096 };
+            for ( int key : keys ) durable.add(key);
+            durable.checkpoint();
+            for ( size_t i {0}; i < n / 10; ++i ) durable.remove(keys[i]);
+        }
+        tree::AVL<int> recovered;
+        double ns { bench::measure(n, [&]{ tree::Durable durable { recovered, path }; }) };
+        out << bench::Result{ "AVL+WAL", "recover", "snapshot_n_log_n/10", n, ns } << '\n';
+        durable_bench_path_();
+    }
+}
@@ -0,0 +1,39 @@
+/*
+    Throughput of Huffman compression on a serialized tree (one operation is one byte).
+*/
+#pragma once
+
+#include <sstream>
+
+#include "bench.hpp"
+#include "..\..\include\avl.hpp"
+#include "..\..\include\huffman.hpp"
+
+
+void bench_huffman(std::ostream& out, size_t n)
+{
+    tree::AVL<int> avl;
+    for ( int key : bench::random_keys(n) ) avl.add(key);
+    std::stringstream text;
+    tree::serialize(avl.root(), text);
+    const std::string raw { text.str() };
+
+    std::string packed;
+    double ns { bench::measure(raw.size(), [&]{
+        std::istringstream in { raw };
+        std::ostringstream compressed;
+        tree::huffman::compress(in, compressed);
+        packed = compressed.str();
+    }) };
+    out << bench::Result{ "huffman", "compress", "serialized_avl", raw.size(), ns } << '\n';
+
+    std::string unpacked;
+    ns = bench::measure(raw.size(), [&]{
+        std::istringstream in { packed };
+        std::ostringstream decompressed;
+        tree::huffman::decompress(in, decompressed);
+        unpacked = decompressed.str();
+    });
+    out << bench::Result{ "huffman", "decompress", "serialized_avl", raw.size(), ns } << '\n';
+    bench::do_not_optimize(unpacked.size() == raw.size());
+}
@@ -0,0 +1,37 @@
+/*
+    Loading a serialized random BST of n keys from a file: the pipelined
+    load_tree against load_tree_parallel on 1 to 16 threads, with the
+    default index of 6 levels.
+*/
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include "bench.hpp"
+#include "..\..\include\bst.hpp"
+#include "..\..\include\indexed.hpp"
+#include "..\..\include\loader.hpp"
+
+
+void bench_indexed(std::ostream& out, size_t n)
+{
+    std::filesystem::path path { std::filesystem::temp_directory_path() / "tree_indexed_bench.tr" };
+    {
+        tree::BST<int> search_tree;
+        for ( int key : bench::random_keys(n) ) search_tree.add(key);
+        tree::serialize_indexed(search_tree.root(), path);
+    }
+    std::unique_ptr<tree::Node<int>> root;
+    double ns { bench::measure(n, [&]{ root = tree::load_tree<int>(path); }) };
+    out << bench::Result{ "load_tree", "load", "random_bst", n, ns } << '\n';
+    root.reset();
+    for ( size_t threads {1}; threads <= 16; threads *= 2 )
+    {
+        ns = bench::measure(n, [&]{ root = tree::load_tree_parallel<int>(path, threads); });
+        out << bench::Result{ "load_tree_parallel", "load", "random_bst_" + std::to_string(threads) + "_threads", n, ns } << '\n';
+        root.reset();
+    }
+    std::filesystem::remove(path);
+    std::filesystem::remove(path.string() + ".idx");
+}
@@ -0,0 +1,46 @@
+/*
+    Overlap queries of IntervalTree against a linear scan of a vector.
+    Intervals start at random points of [0, n) and are up to 100 long.
+*/
+#pragma once
+
+#include <vector>
+
+#include "bench.hpp"
+#include "..\..\include\interval.hpp"
+
+
+void bench_interval(std::ostream& out, size_t n)
+{
+    using Interval = tree::Interval<int, int>;
+    auto starts { bench::random_keys(n) };
+    std::vector<Interval> intervals;
+    intervals.reserve(n);
+    for ( size_t i {0}; i < n; ++i ) intervals.push_back(Interval{ starts[i], starts[i] + static_cast<int>(i % 100), static_cast<int>(i) });
+    auto probes { bench::random_keys(1000, 7) };
+    const int scale { static_cast<int>(std::max<size_t>(1, n / 1000)) };
+    size_t found { 0 };
+
+    tree::IntervalTree<int, int> schedule;
+    double ns { bench::measure(n, [&]{ for ( const auto& interval : intervals ) schedule.insert(interval); }) };
+    out << bench::Result{ "IntervalTree", "insert", "random", n, ns } << '\n';
+
+    ns = bench::measure(probes.size(), [&]{
+        for ( int probe : probes )
+        {
+            int a { probe * scale };
+            schedule.overlapping(a, a + 50, [&](const Interval&){ ++found; });
+        }
+    });
+    out << bench::Result{ "IntervalTree", "overlapping", "random", n, ns } << '\n';
+
+    ns = bench::measure(probes.size(), [&]{
+        for ( int probe : probes )
+        {
+            int a { probe * scale };
+            for ( const auto& interval : intervals ) found += interval.lo <= a + 50 && a <= interval.hi;
+        }
+    });
+    out << bench::Result{ "vector", "overlapping_scan", "random", n, ns } << '\n';
+    bench::do_not_optimize(found);
+}
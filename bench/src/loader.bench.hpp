@@ -0,0 +1,43 @@
+/*
+    Loading a serialized random BST of n keys from a file: deserialize
+    against the pipelined load_tree, and load_tree of the succinct format.
+*/
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+
+#include "bench.hpp"
+#include "..\..\include\bst.hpp"
+#include "..\..\include\loader.hpp"
+#include "..\..\include\succinct.hpp"
+
+
+void bench_loader(std::ostream& out, size_t n)
+{
+    std::filesystem::path text { std::filesystem::temp_directory_path() / "tree_loader_bench.tr" };
+    std::filesystem::path binary { std::filesystem::temp_directory_path() / "tree_loader_bench.sbt" };
+    {
+        tree::BST<int> search_tree;
+        for ( int key : bench::random_keys(n) ) search_tree.add(key);
+        std::ofstream file { text };
+        tree::serialize(search_tree.root(), file);
+        std::ofstream compact { binary, std::ios::binary };
+        tree::SuccinctTree<int>(search_tree.root()).save(compact);
+    }
+    std::unique_ptr<tree::Node<int>> root;
+    double ns { bench::measure(n, [&]{
+        std::ifstream file { text };
+        root = tree::deserialize<int>(file);
+    }) };
+    out << bench::Result{ "deserialize", "load", "random_bst", n, ns } << '\n';
+    root.reset();
+    ns = bench::measure(n, [&]{ root = tree::load_tree<int>(text); });
+    out << bench::Result{ "load_tree", "load", "random_bst", n, ns } << '\n';
+    root.reset();
+    ns = bench::measure(n, [&]{ root = tree::load_tree<int>(binary); });
+    out << bench::Result{ "load_tree", "load", "random_bst_succinct", n, ns } << '\n';
+    root.reset();
+    std::filesystem::remove(text);
+    std::filesystem::remove(binary);
+}
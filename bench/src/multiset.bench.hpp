@@ -0,0 +1,30 @@
+/*
+    Multiset with counted nodes against AVL with a node per duplicate, on
+    Zipfian keys with many duplicates.
+*/
+#pragma once
+
+#include "bench.hpp"
+#include "..\..\include\multiset.hpp"
+
+
+void bench_multiset(std::ostream& out, size_t n)
+{
+    auto keys { bench::zipfian_keys(n) };
+    size_t found { 0 };
+    {
+        tree::AVL<int> search_tree;
+        double ns { bench::measure(n, [&]{ for ( int key : keys ) search_tree.add(key); }) };
+        out << bench::Result{ "AVL", "add", "zipfian", n, ns } << '\n';
+        ns = bench::measure(n, [&]{ for ( int key : keys ) found += search_tree.search(key).has_value(); });
+        out << bench::Result{ "AVL", "search", "zipfian", n, ns } << '\n';
+    }
+    {
+        tree::Multiset<int> counters;
+        double ns { bench::measure(n, [&]{ for ( int key : keys ) counters.add(key); }) };
+        out << bench::Result{ "Multiset", "add", "zipfian", n, ns } << '\n';
+        ns = bench::measure(n, [&]{ for ( int key : keys ) found += counters.contains(key); });
+        out << bench::Result{ "Multiset", "contains", "zipfian", n, ns } << '\n';
+    }
+    bench::do_not_optimize(found);
+}
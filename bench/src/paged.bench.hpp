@@ -0,0 +1,44 @@
+/*
+    Disk-backed AVL with caches of 1 %, 10 % and 100 % of its pages, against
+    the in-memory AVL. Rows named page_reads carry page reads per operation,
+    not nanoseconds, to size the cache by.
+*/
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include "bench.hpp"
+#include "..\..\include\avl.hpp"
+#include "..\..\include\paged.hpp"
+
+
+void bench_paged(std::ostream& out, size_t n)
+{
+    auto keys { bench::random_keys(n) };
+    size_t found { 0 };
+    {
+        tree::AVL<int> search_tree;
+        double ns { bench::measure(n, [&]{ for ( int key : keys ) search_tree.add(key); }) };
+        out << bench::Result{ "AVL", "add", "random", n, ns } << '\n';
+        ns = bench::measure(n, [&]{ for ( int key : keys ) found += search_tree.search(key).has_value(); });
+        out << bench::Result{ "AVL", "search", "random", n, ns } << '\n';
+    }
+    std::filesystem::path path { std::filesystem::temp_directory_path() / "tree_paged_bench.pages" };
+    const size_t data { n * 24 + 4096 };   // Bytes of records of n int keys.
+    for ( size_t percent : {1, 10, 100} )
+    {
+        std::filesystem::remove(path);
+        std::string input { "random_cache_" + std::to_string(percent) + "%" };
+        tree::PagedAVL<int> index { path, data * percent / 100 };
+        double ns { bench::measure(n, [&]{ for ( int key : keys ) index.add(key); }) };
+        out << bench::Result{ "PagedAVL", "add", input, n, ns } << '\n';
+        index.flush();
+        index.reset_stats();
+        ns = bench::measure(n, [&]{ for ( int key : keys ) found += index.contains(key); });
+        out << bench::Result{ "PagedAVL", "search", input, n, ns } << '\n';
+        out << bench::Result{ "PagedAVL", "page_reads", input, n, static_cast<double>(index.stats().reads) / n } << '\n';
+    }
+    std::filesystem::remove(path);
+    bench::do_not_optimize(found);
+}
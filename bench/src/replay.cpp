@@ -0,0 +1,149 @@
+/*
+    Replay a workload trace recorded by tree::Recorder.
+
+    Usage: replay <trace> [bst|avl|set]
+
+    Runs every operation of the trace (32-bit keys) against the chosen tree,
+    default avl, and reports latency percentiles and throughput, overall and
+    for every kind of operation:
+        structure,operation,count,p50_ns,p99_ns,p999_ns,ops_per_s
+*/
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <array>
+#include <string>
+#include <set>
+#include <chrono>
+#include <algorithm>
+#include <optional>
+
+#include "..\..\include\avl.hpp"
+#include "..\..\include\trace.hpp"
+
+
+// std::multiset with the interface of BST.
+class Set_Adapter
+{
+private:
+
+    std::multiset<int> set_;
+
+public:
+
+    void add(int key) { set_.insert(key); }
+
+    std::optional<int> search(int key)
+    {
+        auto it { set_.find(key) };
+        if ( it == set_.end() ) return std::nullopt;
+        return *it;
+    }
+
+    bool remove(int key)
+    {
+        auto it { set_.find(key) };
+        if ( it == set_.end() ) return false;
+        set_.erase(it);
+        return true;
+    }
+
+    std::optional<int> extract_min()
+    {
+        if ( set_.empty() ) return std::nullopt;
+        int result { *set_.begin() };
+        set_.erase(set_.begin());
+        return result;
+    }
+
+    std::optional<int> extract_max()
+    {
+        if ( set_.empty() ) return std::nullopt;
+        int result { *std::prev(set_.end()) };
+        set_.erase(std::prev(set_.end()));
+        return result;
+    }
+};
+
+const std::array<const char*, 5> OP_NAMES { "add", "search", "remove", "extract_min", "extract_max" };
+
+void report(const std::string& structure, const std::string& operation, std::vector<std::uint64_t>& latencies)
+{
+    if ( latencies.empty() ) return;
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) { return latencies[static_cast<size_t>(p * (latencies.size() - 1))]; };
+    std::uint64_t total { 0 };
+    for ( auto latency : latencies ) total += latency;
+    std::cout << structure << ',' << operation << ',' << latencies.size() << ','
+              << percentile(0.5) << ',' << percentile(0.99) << ',' << percentile(0.999) << ','
+              << (total ? 1e9 * latencies.size() / total : 0.0) << '\n';
+}
+
+template<typename Tree>
+void replay(const std::string& structure, const std::vector<tree::Event<int>>& events)
+{
+    using clock = std::chrono::steady_clock;
+    Tree search_tree;
+    std::vector<std::uint64_t> all;
+    std::array<std::vector<std::uint64_t>, 5> by_op;
+    all.reserve(events.size());
+    size_t hits { 0 };
+    for ( const auto& event : events )
+    {
+        auto start { clock::now() };
+        switch ( event.op )
+        {
+        case tree::Op::add:         search_tree.add(event.key);                      break;
+        case tree::Op::search:      hits += search_tree.search(event.key).has_value(); break;
+        case tree::Op::remove:      hits += search_tree.remove(event.key);           break;
+        case tree::Op::extract_min: hits += search_tree.extract_min().has_value();   break;
+        case tree::Op::extract_max: hits += search_tree.extract_max().has_value();   break;
+        }
+        auto stop { clock::now() };
+        std::uint64_t ns { static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) };
+        all.push_back(ns);
+        by_op[static_cast<size_t>(event.op)].push_back(ns);
+    }
+    std::cout << "structure,operation,count,p50_ns,p99_ns,p999_ns,ops_per_s\n";
+    report(structure, "all", all);
+    for ( size_t op {0}; op < by_op.size(); ++op ) report(structure, OP_NAMES[op], by_op[op]);
+    std::cerr << "hits: " << hits << '\n';
+}
+
+int main(int argc, char* argv[])
+{
+    if ( argc < 2 )
+    {
+        std::cerr << "Usage: replay <trace> [bst|avl|set]\n";
+        return 1;
+    }
+    std::string structure { argc > 2 ? argv[2] : "avl" };
+
+    std::ifstream file { argv[1], std::ios::binary };
+    if ( !file )
+    {
+        std::cerr << "Cannot open " << argv[1] << '\n';
+        return 1;
+    }
+    std::vector<tree::Event<int>> events;
+    try
+    {
+        tree::TraceReader<int> reader { file };
+        while ( auto event { reader.next() } ) events.push_back(*event);
+    }
+    catch ( const std::exception& e )
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    if      ( structure == "bst" ) replay<tree::BST<int>>("BST<int>", events);
+    else if ( structure == "avl" ) replay<tree::AVL<int>>("AVL<int>", events);
+    else if ( structure == "set" ) replay<Set_Adapter>("std::multiset<int>", events);
+    else
+    {
+        std::cerr << "Unknown structure " << structure << '\n';
+        return 1;
+    }
+    return 0;
+}
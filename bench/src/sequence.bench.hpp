@@ -0,0 +1,40 @@
+/*
+    Insertion and removal at random positions: Sequence against std::vector.
+    The vector is only run up to 100K elements, it's O(n) per edit.
+*/
+#pragma once
+
+#include <random>
+#include <vector>
+
+#include "bench.hpp"
+#include "..\..\include\sequence.hpp"
+
+
+void bench_sequence(std::ostream& out, size_t n)
+{
+    std::mt19937 generator { 42 };
+    std::vector<size_t> positions(n);
+    for ( size_t i {0}; i < n; ++i ) positions[i] = std::uniform_int_distribution<size_t>{0, i}(generator);
+    size_t found { 0 };
+
+    tree::Sequence<int> sequence;
+    double ns { bench::measure(n, [&]{ for ( size_t i {0}; i < n; ++i ) sequence.insert_at(positions[i], static_cast<int>(i)); }) };
+    out << bench::Result{ "Sequence", "insert_at", "random", n, ns } << '\n';
+    ns = bench::measure(n, [&]{ for ( size_t i {0}; i < n; ++i ) found += sequence.at(positions[i]); });
+    out << bench::Result{ "Sequence", "at", "random", n, ns } << '\n';
+    ns = bench::measure(n, [&]{ for ( int value : sequence ) found += value; });
+    out << bench::Result{ "Sequence", "iterate", "random", n, ns } << '\n';
+    ns = bench::measure(n, [&]{ for ( size_t i {n}; i-- > 0; ) found += sequence.erase_at(positions[i]); });
+    out << bench::Result{ "Sequence", "erase_at", "random", n, ns } << '\n';
+
+    if ( n <= 100'000 )
+    {
+        std::vector<int> vector;
+        ns = bench::measure(n, [&]{ for ( size_t i {0}; i < n; ++i ) vector.insert(vector.begin() + positions[i], static_cast<int>(i)); });
+        out << bench::Result{ "std::vector", "insert", "random", n, ns } << '\n';
+        ns = bench::measure(n, [&]{ for ( size_t i {n}; i-- > 0; ) { found += vector[positions[i]]; vector.erase(vector.begin() + positions[i]); } });
+        out << bench::Result{ "std::vector", "erase", "random", n, ns } << '\n';
+    }
+    bench::do_not_optimize(found);
+}
@@ -0,0 +1,73 @@
+/*
+    Write scaling of a sharded AVL against one AVL behind one lock, with 1 to
+    64 threads adding disjoint random keys.
+*/
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "..\..\include\sharded.hpp"
+
+
+// Run threads copies of fnc(first, last) over equal parts of keys.
+template<typename F>
+void run_threads_(size_t threads, const std::vector<int>& keys, F fnc)
+{
+    std::vector<std::thread> workers;
+    size_t part { keys.size() / threads };
+    for ( size_t t {0}; t < threads; ++t )
+    {
+        auto first { keys.begin() + t * part };
+        auto last { t + 1 == threads ? keys.end() : first + part };
+        workers.emplace_back([=]{ fnc(first, last); });
+    }
+    for ( std::thread& worker : workers ) worker.join();
+}
+
+void bench_sharded(std::ostream& out, size_t n)
+{
+    auto keys { bench::random_keys(n) };
+    for ( size_t threads {1}; threads <= 64; threads *= 2 )
+    {
+        std::string input { "random_" + std::to_string(threads) + "_threads" };
+        {
+            tree::AVL<int> search_tree;
+            std::mutex mutex;
+            double ns { bench::measure(n, [&]{
+                run_threads_(threads, keys, [&](auto first, auto last){
+                    for ( ; first != last; ++first )
+                    {
+                        std::lock_guard lock { mutex };
+                        search_tree.add(*first);
+                    }
+                });
+            }) };
+            out << bench::Result{ "AVL+mutex", "add", input, n, ns } << '\n';
+        }
+        {
+            tree::ShardedAVL<int, 64> index;
+            double ns { bench::measure(n, [&]{
+                run_threads_(threads, keys, [&](auto first, auto last){
+                    for ( ; first != last; ++first ) index.add(*first);
+                });
+            }) };
+            out << bench::Result{ "ShardedAVL<64>", "add", input, n, ns } << '\n';
+            size_t found { 0 };
+            ns = bench::measure(n, [&]{
+                run_threads_(threads, keys, [&](auto first, auto last){
+                    size_t local { 0 };
+                    for ( ; first != last; ++first ) local += index.contains(*first);
+                    static std::mutex sum;
+                    std::lock_guard lock { sum };
+                    found += local;
+                });
+            });
+            out << bench::Result{ "ShardedAVL<64>", "contains", input, n, ns } << '\n';
+            bench::do_not_optimize(found);
+        }
+    }
+}
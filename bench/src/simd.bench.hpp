@@ -0,0 +1,48 @@
+/*
+    Search throughput of k-ary SIMD search tree against Eytzinger layout and AVL.
+*/
+#pragma once
+
+#include <algorithm>
+
+#include "bench.hpp"
+#include "..\..\include\avl.hpp"
+#include "..\..\include\array.hpp"
+#include "..\..\include\simd.hpp"
+
+
+void bench_simd(std::ostream& out, size_t n)
+{
+    auto keys { bench::random_keys(n) };
+    auto probes { bench::random_keys(n, 7) };
+    std::vector<int> sorted { keys };
+    std::sort(sorted.begin(), sorted.end());
+    size_t found { 0 };
+
+    tree::AVL<int> avl;
+    for ( int key : keys ) avl.add(key);
+    double ns { bench::measure(n, [&]{
+        for ( int key : probes ) found += avl.search(key).has_value();
+    }) };
+    out << bench::Result{ "AVL", "search", "random", n, ns } << '\n';
+
+    tree::Eytzinger<int> eytzinger { sorted };
+    ns = bench::measure(n, [&]{
+        for ( int key : probes ) found += eytzinger.contains(key);
+    });
+    out << bench::Result{ "Eytzinger", "contains", "random", n, ns } << '\n';
+
+    tree::SimdSearchTree<int> simd { sorted };
+    for ( auto isa : {tree::Isa::scalar, tree::Isa::sse, tree::Isa::avx2} )
+    {
+        simd.isa(isa);
+        if ( simd.isa() != isa ) continue;  // Not supported by this CPU.
+        const char* name { isa == tree::Isa::avx2 ? "SimdSearchTree_avx2" :
+                           isa == tree::Isa::sse  ? "SimdSearchTree_sse"  : "SimdSearchTree_scalar" };
+        ns = bench::measure(n, [&]{
+            for ( int key : probes ) found += simd.contains(key);
+        });
+        out << bench::Result{ name, "contains", "random", n, ns } << '\n';
+    }
+    bench::do_not_optimize(found);
+}
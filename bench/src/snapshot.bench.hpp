@@ -0,0 +1,70 @@
+/*
+    Writer pause of snapshots: the longest wait of an add while the tree of n
+    keys is written to disk, stop-the-world serialize against a background
+    snapshot_to, and add throughput during the background snapshot.
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "bench.hpp"
+#include "..\..\include\avl.hpp"
+#include "..\..\include\snapshot.hpp"
+
+
+void bench_snapshot(std::ostream& out, size_t n)
+{
+    auto keys { bench::random_keys(2 * n) };
+    std::filesystem::path path { std::filesystem::temp_directory_path() / "tree_snapshot_bench.trc" };
+    using clock = std::chrono::steady_clock;
+    {
+        tree::AVL<int> search_tree;
+        for ( size_t i {0}; i < n; ++i ) search_tree.add(keys[i]);
+        std::mutex mutex;
+        std::atomic<bool> dumping { true };
+        std::thread dump { [&]{
+            std::lock_guard lock { mutex };
+            std::ofstream file { path };
+            tree::serialize(search_tree.root(), file);
+            dumping = false;
+        } };
+        double pause { 0 };
+        for ( size_t i {n}; i < 2 * n && dumping; ++i )
+        {
+            auto start { clock::now() };
+            {
+                std::lock_guard lock { mutex };
+                search_tree.add(keys[i]);
+            }
+            pause = std::max(pause, std::chrono::duration<double, std::nano>(clock::now() - start).count());
+        }
+        dump.join();
+        out << bench::Result{ "AVL+serialize", "max_add_pause", "random", n, pause } << '\n';
+    }
+    {
+        tree::AVL<int> search_tree;
+        for ( size_t i {0}; i < n; ++i ) search_tree.add(keys[i]);
+        tree::Snapshotting snapshots { search_tree };
+        auto written { snapshots.snapshot_to(path) };
+        double pause { 0 };
+        size_t adds { 0 };
+        double ns { bench::measure(1, [&]{
+            for ( size_t i {n}; i < 2 * n && written.wait_for(std::chrono::seconds(0)) != std::future_status::ready; ++i, ++adds )
+            {
+                auto start { clock::now() };
+                snapshots.add(keys[i]);
+                pause = std::max(pause, std::chrono::duration<double, std::nano>(clock::now() - start).count());
+            }
+        }) };
+        bench::do_not_optimize(written.get());
+        out << bench::Result{ "AVL+snapshot_to", "max_add_pause", "random", n, pause } << '\n';
+        out << bench::Result{ "AVL+snapshot_to", "add_during_snapshot", "random", n, adds ? ns / adds : 0 } << '\n';
+    }
+    std::filesystem::remove(path);
+}
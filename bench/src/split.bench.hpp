@@ -0,0 +1,64 @@
+/*
+    Search throughput of hot/cold split AVL against AVL<T> at several payload sizes.
+*/
+#pragma once
+
+#include <array>
+
+#include "bench.hpp"
+#include "..\..\include\avl.hpp"
+#include "..\..\include\split.hpp"
+
+
+template<size_t N>
+struct Payload
+{
+    int key;
+    std::array<char, N> bytes {};
+    Payload(int key_ = 0) : key{key_} {}
+    auto operator<=>(const Payload& other) const { return key <=> other.key; }
+    bool operator==(const Payload& other) const { return key == other.key; }
+};
+
+struct Payload_Key
+{
+    template<typename P>
+    int operator()(const P& payload) const { return payload.key; }
+};
+
+template<size_t N>
+void bench_split_payload(std::ostream& out, size_t n)
+{
+    const std::string input { "payload_" + std::to_string(N) };
+    auto keys { bench::random_keys(n) };
+
+    tree::AVL<Payload<N>> avl;
+    tree::SplitAVL<Payload<N>, Payload_Key> split;
+    split.reserve(n);
+    for ( int key : keys ) avl.add(Payload<N>(key));
+    for ( int key : keys ) split.add(Payload<N>(key));
+
+    auto probes { bench::random_keys(n, 7) };
+    size_t found { 0 };
+    double ns { bench::measure(n, [&]{
+        for ( int key : probes ) found += avl.search(Payload<N>(key)).has_value();
+    }) };
+    out << bench::Result{ "AVL", "search", input, n, ns } << '\n';
+    ns = bench::measure(n, [&]{
+        for ( int key : probes ) found += split.contains(key);
+    });
+    out << bench::Result{ "SplitAVL", "contains", input, n, ns } << '\n';
+    ns = bench::measure(n, [&]{
+        for ( int key : probes ) found += split.find(key) != nullptr;
+    });
+    out << bench::Result{ "SplitAVL", "find", input, n, ns } << '\n';
+    bench::do_not_optimize(found);
+}
+
+void bench_split(std::ostream& out, size_t n)
+{
+    bench_split_payload<8>(out, n);
+    bench_split_payload<64>(out, n);
+    bench_split_payload<256>(out, n);
+    bench_split_payload<1024>(out, n);
+}
@@ -0,0 +1,85 @@
+/*
+    Succinct tree against pointer nodes on a random tree shape: building it,
+    a depth-first walk summing values, and space. Rows named bytes_per_node
+    carry bytes, not nanoseconds: in memory (node size without allocator
+    overhead) and in a file (serialize text against the succinct format).
+*/
+#pragma once
+
+#include <memory>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "bench.hpp"
+#include "..\..\include\linked.hpp"
+#include "..\..\include\succinct.hpp"
+
+
+// Random binary tree (not a search tree) of count nodes.
+inline std::unique_ptr<tree::Node<int>> random_shape(size_t count, unsigned int seed = 42)
+{
+    std::mt19937 generator { seed };
+    auto root { std::make_unique<tree::Node<int>>(0) };
+    std::vector<tree::Node<int>*> open { root.get() };
+    for ( size_t value {1}; value < count; ++value )
+    {
+        size_t index { std::uniform_int_distribution<size_t>{ 0, open.size() - 1 }(generator) };
+        tree::Node<int>* node { open[index] };
+        bool go_left { !node->left() && (node->right() || generator() % 2) };
+        int data { static_cast<int>(value) };
+        tree::Node<int>* child { (go_left ? node->left(data) : node->right(data)).get() };
+        if ( node->left() && node->right() )
+        {
+            open[index] = open.back();
+            open.pop_back();
+        }
+        open.push_back(child);
+    }
+    return root;
+}
+
+void bench_succinct(std::ostream& out, size_t n)
+{
+    auto root { random_shape(n) };
+    long long sum { 0 };
+    double ns { bench::measure(n, [&]{
+        std::vector<const tree::Node<int>*> stack { root.get() };
+        while ( !stack.empty() )
+        {
+            const tree::Node<int>* node { stack.back() };
+            stack.pop_back();
+            sum += node->data;
+            if ( node->right() ) stack.push_back(node->right().get());
+            if ( node->left() )  stack.push_back(node->left().get());
+        }
+    }) };
+    out << bench::Result{ "Node", "dfs", "random_shape", n, ns } << '\n';
+    out << bench::Result{ "Node", "bytes_per_node", "memory", n, static_cast<double>(sizeof(tree::Node<int>)) } << '\n';
+    std::ostringstream text;
+    tree::serialize(root, text);
+    out << bench::Result{ "Node", "bytes_per_node", "serialize", n, static_cast<double>(text.str().size()) / n } << '\n';
+
+    tree::SuccinctTree<int> compact;
+    ns = bench::measure(n, [&]{ compact = tree::SuccinctTree<int>(root); });
+    out << bench::Result{ "SuccinctTree", "build", "random_shape", n, ns } << '\n';
+    ns = bench::measure(n, [&]{
+        std::vector<size_t> stack { compact.root() };
+        while ( !stack.empty() )
+        {
+            size_t k { stack.back() };
+            stack.pop_back();
+            sum += compact[k];
+            if ( size_t right { compact.right(k) } ) stack.push_back(right);
+            if ( size_t left { compact.left(k) } )   stack.push_back(left);
+        }
+    });
+    out << bench::Result{ "SuccinctTree", "dfs", "random_shape", n, ns } << '\n';
+    out << bench::Result{ "SuccinctTree", "bytes_per_node", "memory", n, static_cast<double>(compact.memory()) / n } << '\n';
+    std::ostringstream binary;
+    compact.save(binary);
+    out << bench::Result{ "SuccinctTree", "bytes_per_node", "save", n, static_cast<double>(binary.str().size()) / n } << '\n';
+    ns = bench::measure(n, [&]{ root = compact.to_nodes(); });
+    out << bench::Result{ "SuccinctTree", "to_nodes", "random_shape", n, ns } << '\n';
+    bench::do_not_optimize(sum);
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <iterator>
+#include <bit>
+
+#include "bst.hpp"
+
+
+namespace tree
+{
+
+/*
+    Read-only search tree stored in an array using Eytzinger (BFS) layout.
+
+    The tree is complete, node at index k (1-based) has its children at 2k and
+    2k + 1. Search is branch-free, and the first levels of the tree share few
+    cache lines, which the hardware prefetcher handles well.
+
+    Built from a sorted range or from the in-order traversal of a BST/AVL.
+*/
+template<typename T>
+class Eytzinger
+{
+private:
+
+    std::vector<T> data_;   // data_[0] is unused, the root lives at index 1.
+
+    // Fill data_ with sorted values by in-order traversal of the implicit tree.
+    template<typename It>
+    void fill_(It& it, size_t k)
+    {
+        if ( k >= data_.size() ) return;
+        fill_(it, 2 * k);
+        data_[k] = *it;
+        ++it;
+        fill_(it, 2 * k + 1);
+    }
+
+    template<typename It>
+    void build_(It first, It last)
+    {
+        std::vector<T> sorted(first, last);
+        data_.resize(sorted.size() + 1);
+        auto it { sorted.begin() };
+        fill_(it, 1);
+    }
+
+    // Index of the first element not less than key, 0 if there is none.
+    size_t lower_bound_index_(const T& key) const
+    {
+        size_t k { 1 };
+        size_t n { data_.size() };
+        while ( k < n ) k = 2 * k + (data_[k] < key);
+        // Climb back up over the right turns, and once more over the last left turn.
+        k >>= std::countr_one(k) + 1;
+        return k;
+    }
+
+    // Index of the first element greater than key, 0 if there is none.
+    size_t upper_bound_index_(const T& key) const
+    {
+        size_t k { 1 };
+        size_t n { data_.size() };
+        while ( k < n ) k = 2 * k + !(key < data_[k]);
+        k >>= std::countr_one(k) + 1;
+        return k;
+    }
+
+    // Index of the last element for which go_right holds, 0 if there is none.
+    // The descent stays branch-free, the candidate is picked by a conditional move.
+    template<typename F>
+    size_t last_index_(F go_right) const
+    {
+        size_t k { 1 };
+        size_t candidate { 0 };
+        size_t n { data_.size() };
+        while ( k < n )
+        {
+            bool right { go_right(data_[k]) };
+            candidate = right ? k : candidate;
+            k = 2 * k + right;
+        }
+        return candidate;
+    }
+
+    std::optional<T> at_(size_t k) const
+    {
+        if ( k == 0 ) return std::nullopt;
+        return data_[k];
+    }
+
+public:
+
+    /*
+        Constructors
+    */
+    Eytzinger() : data_(1) {}
+
+    // Values must be sorted.
+    Eytzinger(const std::vector<T>& sorted) { build_(sorted.begin(), sorted.end()); }
+
+    // Values must be sorted.
+    template<std::input_iterator It>
+    Eytzinger(It first, It last) { build_(first, last); }
+
+    template<typename S>
+    Eytzinger(BST<T, S>& search_tree) { build_(search_tree.begin(), search_tree.end()); }
+
+    /*
+        Public member functions
+    */
+
+    size_t size() const { return data_.size() - 1; }
+    bool empty() const { return size() == 0; }
+
+    bool contains(const T& key) const
+    {
+        size_t k { lower_bound_index_(key) };
+        return k != 0 && data_[k] == key;
+    }
+
+    // Smallest value not less than key.
+    std::optional<T> lower_bound(const T& key) const
+    {
+        size_t k { lower_bound_index_(key) };
+        if ( k == 0 ) return std::nullopt;
+        return data_[k];
+    }
+
+    // Same as lower_bound.
+    std::optional<T> ceiling(const T& key) const { return lower_bound(key); }
+
+    // Smallest value greater than key.
+    std::optional<T> successor(const T& key) const { return at_(upper_bound_index_(key)); }
+
+    // Largest value not greater than key.
+    std::optional<T> floor(const T& key) const
+    {
+        return at_(last_index_([&](const T& value){ return !(key < value); }));
+    }
+
+    // Largest value smaller than key.
+    std::optional<T> predecessor(const T& key) const
+    {
+        return at_(last_index_([&](const T& value){ return value < key; }));
+    }
+
+    // Value closest to key, the smaller one on ties.
+    std::optional<T> nearest(const T& key) const { return detail::nearer(key, floor(key), ceiling(key)); }
+
+    // Values in layout order, data()[0] is the root.
+    const T* data() const { return data_.data() + 1; }
+
+};
+
+}  // namespace tree
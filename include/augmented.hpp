@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "avl.hpp"
+
+
+namespace tree
+{
+
+/*
+    AVL tree that keeps a summary of every subtree.
+
+    The summary is defined by a monoid over the values:
+
+        struct Monoid
+        {
+            using summary_type = ...;
+            static summary_type identity();                  // Summary of no values.
+            static summary_type lift(const T& value);        // Summary of one value.
+            static summary_type combine(const summary_type& left, const summary_type& right);
+        };
+
+    combine must be associative. Summaries are kept up to date by rotations,
+    add and remove (through the augmentation policy of AVL), so a range of
+    keys is summarized in O(log n) by aggregate(lo, hi).
+
+        tree::AugmentedAVL<int, tree::SumOf<int>> search_tree;
+        ...
+        long long total { search_tree.aggregate(10, 20) };
+*/
+
+// Ready-made monoids.
+
+template<typename T>
+struct SumOf
+{
+    using summary_type = T;
+    static summary_type identity() { return T{}; }
+    static summary_type lift(const T& value) { return value; }
+    static summary_type combine(const summary_type& left, const summary_type& right) { return left + right; }
+};
+
+template<typename T>
+struct CountOf
+{
+    using summary_type = size_t;
+    static summary_type identity() { return 0; }
+    static summary_type lift(const T&) { return 1; }
+    static summary_type combine(summary_type left, summary_type right) { return left + right; }
+};
+
+// Empty optional for no values.
+template<typename T>
+struct MinOf
+{
+    using summary_type = std::optional<T>;
+    static summary_type identity() { return std::nullopt; }
+    static summary_type lift(const T& value) { return value; }
+    static summary_type combine(const summary_type& left, const summary_type& right)
+    {
+        if ( !left ) return right;
+        if ( !right ) return left;
+        return std::min(*left, *right);
+    }
+};
+
+// Empty optional for no values.
+template<typename T>
+struct MaxOf
+{
+    using summary_type = std::optional<T>;
+    static summary_type identity() { return std::nullopt; }
+    static summary_type lift(const T& value) { return value; }
+    static summary_type combine(const summary_type& left, const summary_type& right)
+    {
+        if ( !left ) return right;
+        if ( !right ) return left;
+        return std::max(*left, *right);
+    }
+};
+
+// Value stored in a node of AugmentedAVL, ordered by value only.
+template<typename T, typename Monoid>
+struct Augmented
+{
+    T value;
+    typename Monoid::summary_type summary { Monoid::identity() };
+
+    Augmented() {}
+    Augmented(T value_) : value{std::move(value_)}, summary{Monoid::lift(value)} {}
+
+    auto operator<=>(const Augmented& other) const { return value <=> other.value; }
+    bool operator==(const Augmented& other) const { return value == other.value; }
+};
+
+// Augmentation policy keeping the summary of a node's subtree.
+template<typename Monoid>
+struct Summarize
+{
+    static constexpr bool enabled { true };
+
+    template<typename A>
+    static typename Monoid::summary_type of(const std::unique_ptr<Node<A>>& node)
+    {
+        return node ? node->data.summary : Monoid::identity();
+    }
+
+    template<typename A>
+    static void update(Node<A>& node)
+    {
+        node.data.summary = Monoid::combine(Monoid::combine(of(node.left()), Monoid::lift(node.data.value)),
+                                           of(node.right()));
+    }
+};
+
+template<typename T, typename Monoid, typename Stats = NoStats>
+class AugmentedAVL
+{
+public:
+
+    using summary_type = typename Monoid::summary_type;
+    using value_type = Augmented<T, Monoid>;
+
+private:
+
+    using Policy = Summarize<Monoid>;
+
+    AVL<value_type, Stats, Policy> tree_;
+
+    // Summary of values of subtree not less than lo. Values right of a node are not less than it.
+    static summary_type from_(const Node<value_type>* it, const T& lo)
+    {
+        summary_type result { Monoid::identity() };
+        while ( it )
+        {
+            if ( it->data.value < lo ) it = it->right().get();
+            else
+            {
+                result = Monoid::combine(Monoid::combine(Monoid::lift(it->data.value), Policy::of(it->right())), result);
+                it = it->left().get();
+            }
+        }
+        return result;
+    }
+
+    // Summary of values of subtree not greater than hi.
+    static summary_type up_to_(const Node<value_type>* it, const T& hi)
+    {
+        summary_type result { Monoid::identity() };
+        while ( it )
+        {
+            if ( hi < it->data.value ) it = it->left().get();
+            else
+            {
+                result = Monoid::combine(result, Monoid::combine(Policy::of(it->left()), Monoid::lift(it->data.value)));
+                it = it->right().get();
+            }
+        }
+        return result;
+    }
+
+public:
+
+    /*
+        Constructors
+    */
+    AugmentedAVL() {}
+
+    AugmentedAVL(const std::vector<T>& data) { for ( const T& value : data ) add(value); }
+
+    /*
+        Public member functions
+    */
+
+    void add(const T& value) { tree_.add(value_type(value)); }
+
+    bool remove(const T& value) { return tree_.remove(value_type(value)); }
+
+    bool contains(const T& value) { return static_cast<bool>(tree_.find(value_type(value))); }
+
+    /*
+        Summary of values in [lo, hi], in order of values. Descends to the node
+        where paths to lo and hi split, then down both paths, taking whole
+        subtrees that lie inside the range: O(log n).
+    */
+    summary_type aggregate(const T& lo, const T& hi) const
+    {
+        const Node<value_type>* it { tree_.root().get() };
+        while ( it )
+        {
+            if      ( it->data.value < lo ) it = it->right().get();
+            else if ( hi < it->data.value ) it = it->left().get();
+            else break;
+        }
+        if ( !it ) return Monoid::identity();
+        return Monoid::combine(Monoid::combine(from_(it->left().get(), lo), Monoid::lift(it->data.value)),
+                               up_to_(it->right().get(), hi));
+    }
+
+    // Summary of all values.
+    summary_type aggregate() const { return Policy::of(tree_.root()); }
+
+    AVL<value_type, Stats, Policy>& tree() { return tree_; }
+
+};
+
+}  // namespace tree
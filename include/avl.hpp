@@ -6,72 +6,124 @@
 namespace tree
 {
 
-template<typename T>
-class AVL : public BST<T>
+/*
+    Augmentation policy of AVL. update is called whenever a node's children
+    change, after its height is updated, so a node can keep a summary of its
+    subtree (see augmented.hpp). NoAugment keeps nothing.
+*/
+struct NoAugment
 {
-private:
+    static constexpr bool enabled { false };
+
+    template<typename T>
+    static void update(Node<T>&) {}
+};
+
+/*
+    AVL rotations and balancing of a single node, shared by AVL and by trees
+    that aren't ordered by key (see sequence.hpp). Heights and augmentation
+    are updated bottom up; Stats counts rotations and balancing.
+*/
+template<typename T, typename Augment = NoAugment, typename Stats = NoStats>
+struct Rebalance
+{
+    static void update(std::unique_ptr<Node<T>>& node)
+    {
+        update_height(node);
+        Augment::update(*node);
+    }
 
-    static void rotate_left_(std::unique_ptr<Node<T>>& node)
+    static void rotate_left(std::unique_ptr<Node<T>>& node, Stats& stats)
     {
+        stats.rotation();
         auto temp { node->release_right() };
         node->right(temp->release_left());
-        std::swap(node, temp);
-        node->left(std::move(temp));
-        update_height(node->left());
-        update_height(node);;
+        auto old { Node<T>::replace(node, std::move(temp)) };
+        node->left(std::move(old));
+        update(node->left());
+        update(node);
     }
 
-    static void rotate_right_(std::unique_ptr<Node<T>>& node)
+    static void rotate_right(std::unique_ptr<Node<T>>& node, Stats& stats)
     {
+        stats.rotation();
         auto temp { node->release_left() };
         node->left(temp->release_right());
-        std::swap(node, temp);
-        node->right(std::move(temp));
-        update_height(node->right());
-        update_height(node);
+        auto old { Node<T>::replace(node, std::move(temp)) };
+        node->right(std::move(old));
+        update(node->right());
+        update(node);
     }
 
-    static void balance_(std::unique_ptr<Node<T>>& it)
+    static void balance(std::unique_ptr<Node<T>>& it, Stats& stats)
     {
         if ( !it ) return;
-        update_height(it);
+        stats.balance();
+        update(it);
         switch (skew(it))
         {
         case 2:  // Right heavy
-            if ( skew(it->right()) <= -1 ) rotate_right_(it->right());
-            rotate_left_(it);
+            if ( skew(it->right()) <= -1 ) rotate_right(it->right(), stats);
+            rotate_left(it, stats);
             break;
         case -2:  // Left heavy
-            if ( skew(it->left()) >= 1 ) rotate_left_(it->left());
-            rotate_right_(it);
+            if ( skew(it->left()) >= 1 ) rotate_left(it->left(), stats);
+            rotate_right(it, stats);
         default:
             break;
         }
     }
+};
 
-    void add_(T data, std::unique_ptr<Node<T>>& node) override
+template<typename T, typename Stats = NoStats, typename Augment = NoAugment>
+class AVL : public BST<T, Stats>
+{
+private:
+
+    using BST<T, Stats>::stats_;
+
+    void balance_(std::unique_ptr<Node<T>>& it)
+    {
+        Rebalance<T, Augment, Stats>::balance(it, stats_);
+    }
+
+    // Rebalance ancestors of an attached leaf, bottom up, until a subtree keeps
+    // its height. Summaries of augmented trees change up to the root.
+    void retrace_(Node<T>* node) override
     {
-        BST<T>::add_(data, node);
+        while ( node )
+        {
+            auto& slot { this->slot_(node) };
+            size_t before { height(slot) };
+            balance_(slot);
+            if ( !Augment::enabled && height(slot) == before ) break;
+            node = slot->parent();
+        }
+    }
+
+    void add_(T data, std::unique_ptr<Node<T>>& node, size_t depth) override
+    {
+        BST<T, Stats>::add_(data, node, depth);
         balance_(node);
     }
 
     T extract_max_(std::unique_ptr<Node<T>>& it) override
     {
-        T result { BST<T>::extract_max_(it) };
+        T result { BST<T, Stats>::extract_max_(it) };
         balance_(it);
         return result;
     }
 
     T extract_min_(std::unique_ptr<Node<T>>& it) override
     {
-        T result { BST<T>::extract_min_(it) };
+        T result { BST<T, Stats>::extract_min_(it) };
         balance_(it);
         return result;
     }
 
     bool remove_(T key, std::unique_ptr<Node<T>>& it) override
     {
-        bool result { BST<T>::remove_(key, it) };
+        bool result { BST<T, Stats>::remove_(key, it) };
         balance_(it);
         return result;
     }
@@ -83,16 +135,16 @@ public:
     */
     AVL() {}
 
-    AVL(T data) : BST<T>(data) {}
+    AVL(T data) : BST<T, Stats>(data) {}
 
     template<typename... Args>
     requires (sizeof...(Args) > 0)
     explicit AVL(Args&&... args)
-        : BST<T>{std::forward<Args>(args)...} {}
+        : BST<T, Stats>{std::forward<Args>(args)...} {}
 
     AVL(std::vector<T> data)
     {
-        BST<T>();
+        BST<T, Stats>();
         for ( int i {0}; i < data.size(); ++i )
         {
             this->add(data.at(i));
@@ -102,4 +154,3 @@ public:
 };
 
 } // namespace tree
-
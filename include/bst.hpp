@@ -1,43 +1,186 @@
 #pragma once
 
 #include <memory>
+#include <vector>
+#include <span>
+#include <ranges>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <xmmintrin.h>
+#endif
 
 #include "linked.hpp"
+#include "stats.hpp"
+#include "reclaim.hpp"
 
 namespace tree
 {
 
+namespace detail
+{
 
+// Hint that address will be read soon.
+inline void prefetch(const void* address)
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(address);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#endif
+}
+
+/*
+    Of the candidates below and above key, the closer one, the one below on
+    ties. Integer differences are taken as unsigned, so they can't overflow.
+*/
 template<typename T>
+std::optional<T> nearer(const T& key, const std::optional<T>& below, const std::optional<T>& above)
+{
+    if ( !below ) return above;
+    if ( !above ) return below;
+    if constexpr ( std::is_integral_v<T> )
+    {
+        using U = std::make_unsigned_t<T>;
+        return U(U(*above) - U(key)) < U(U(key) - U(*below)) ? above : below;
+    }
+    else return (*above - key) < (key - *below) ? above : below;
+}
+
+}  // namespace detail
+
+
+/*
+    Stats is an instrumentation policy, see stats.hpp.
+*/
+template<typename T, typename Stats = NoStats>
 class BST
 {
 protected:
 
     std::unique_ptr<Node<T>> root_ { nullptr };
+    [[no_unique_address]] mutable Stats stats_;
+
+    // Cached smallest and largest node, so keys beyond either end are attached
+    // without descending. nullptr when unknown, found again on the next add.
+    Node<T>* leftmost_  { nullptr };
+    Node<T>* rightmost_ { nullptr };
 
-    // Recursive helper member function for adding nodes.
-    virtual void add_(T data, std::unique_ptr<Node<T>>& node)
+    void forget_ends_() { leftmost_ = rightmost_ = nullptr; }
+
+    // Owning pointer of a node.
+    std::unique_ptr<Node<T>>& slot_(Node<T>* node)
     {
+        Node<T>* parent { node->parent() };
+        if ( !parent ) return root_;
+        return node == parent->left().get() ? parent->left() : parent->right();
+    }
+
+    /*
+        Called with the parent of a leaf attached outside of add_, i.e. by the
+        fast path of add and by insert_hint. BST has nothing to fix, AVL
+        rebalances the ancestors.
+    */
+    virtual void retrace_(Node<T>*) {}
+
+    // Attach data as a leaf in the given empty child slot of parent, return the new node.
+    Node<T>* attach_leaf_(T data, Node<T>* parent, bool left)
+    {
+        Node<T>* node { (left ? parent->left(data) : parent->right(data)).get() };
+        stats_.allocation();
+        if constexpr ( Stats::enabled )
+        {
+            size_t depth { 1 };
+            for ( const Node<T>* it { node }; it->parent(); it = it->parent() ) ++depth;
+            stats_.descent(depth);
+        }
+        retrace_(parent);
+        return node;
+    }
+
+    // Recursive helper member function for adding nodes. Depth of node, root is at depth 1.
+    virtual void add_(T data, std::unique_ptr<Node<T>>& node, size_t depth)
+    {
+        stats_.comparison();
         if ( data <= node->data )
         {
-            if ( !node->left() ) node->left(data);
-            else                 add_(data, node->left());
+            if ( !node->left() ) attach_left_(data, node, depth);
+            else                 add_(data, node->left(), depth + 1);
 
         }
         else
         {
-            if ( !node->right() ) node->right(data);
-            else                  add_(data, node->right());
+            if ( !node->right() ) attach_right_(data, node, depth);
+            else                  add_(data, node->right(), depth + 1);
         }
     }
 
-    // Recursive helper member function for search.
-    static std::optional<T> search_(T key, const std::unique_ptr<Node<T>>& node)
+    void attach_left_(T data, std::unique_ptr<Node<T>>& node, size_t depth)
     {
-        if ( !node )             return std::nullopt;
-        if ( key == node->data ) return node->data;
-        if ( key < node->data  ) return search_(key, node->left());
-        else                     return search_(key, node->right());
+        node->left(data);
+        stats_.allocation();
+        stats_.descent(depth + 1);
+    }
+
+    void attach_right_(T data, std::unique_ptr<Node<T>>& node, size_t depth)
+    {
+        node->right(data);
+        stats_.allocation();
+        stats_.descent(depth + 1);
+    }
+
+    // Helper member function for search.
+    std::optional<T> search_(T key, const std::unique_ptr<Node<T>>& node) const
+    {
+        const Node<T>* it { node.get() };
+        size_t depth { 0 };
+        std::optional<T> result { std::nullopt };
+        while ( it )
+        {
+            ++depth;
+            stats_.comparison();
+            if ( key == it->data ) { result = it->data; break; }
+            it = key < it->data ? it->left().get() : it->right().get();
+        }
+        stats_.descent(depth);
+        return result;
+    }
+
+    /*
+        Search for key starting from finger, the node where the previous search
+        ended, and leave finger where this search ends. Keys of consecutive
+        calls must not decrease. The search climbs only to the lowest ancestor
+        whose subtree may hold key, then descends as usual.
+    */
+    const Node<T>* finger_search_(const T& key, const Node<T>*& finger) const
+    {
+        const Node<T>* it { finger ? finger : root_.get() };
+        if ( finger )
+        {
+            // Nodes above a left edge bound the subtree from above. Climb until key is below that bound.
+            while ( const Node<T>* parent { it->parent() } )
+            {
+                bool from_left { it == parent->left().get() };
+                it = parent;
+                stats_.comparison();
+                if ( from_left && key < parent->data ) { it = parent->left().get(); break; }
+            }
+        }
+        size_t depth { 0 };
+        const Node<T>* found { nullptr };
+        while ( it )
+        {
+            finger = it;
+            ++depth;
+            stats_.comparison();
+            if ( key == it->data ) { found = it; break; }
+            it = key < it->data ? it->left().get() : it->right().get();
+        }
+        stats_.descent(depth);
+        return found;
     }
 
     // Recursive helper member function for finding maximum value
@@ -59,7 +202,8 @@ protected:
     {
         if ( it->right() ) return extract_max_(it->right());
         T result { it->data };
-        it = std::move(it->release_left());
+        Node<T>::replace(it, it->release_left());
+        stats_.free();
         return result;
     }
 
@@ -68,7 +212,8 @@ protected:
     {
         if ( it->left() ) return extract_min_(it->left());
         T result { it->data };
-        it = std::move(it->release_right());
+        Node<T>::replace(it, it->release_right());
+        stats_.free();
         return result;
     }
 
@@ -80,10 +225,10 @@ protected:
         {
             switch ( it->degree() )
             {
-            case Degree::none:       it.reset();                           break;
-            case Degree::only_right: it = std::move(it->release_right());  break;
-            case Degree::only_left:  it = std::move(it->release_left());   break;
-            case Degree::both:       it->data = extract_min_(it->right()); break;
+            case Degree::none:       it.reset();                          stats_.free(); break;
+            case Degree::only_right: Node<T>::replace(it, it->release_right()); stats_.free(); break;
+            case Degree::only_left:  Node<T>::replace(it, it->release_left());  stats_.free(); break;
+            case Degree::both:       it->data = extract_min_(it->right()); break;  // Frees the minimum.
             default: break;
             }
             return true;
@@ -104,6 +249,7 @@ public:
     BST(T data)
     {
         root_ = std::make_unique<Node<T>>(data);
+        stats_.allocation();
     }
 
     template<typename... Args>
@@ -111,6 +257,7 @@ public:
     explicit BST(Args&&... args)
     {
         root_ = std::make_unique<Node<T>>(std::forward<Args>(args)...);
+        stats_.allocation();
     }
 
     BST(std::vector<T> data)
@@ -119,6 +266,7 @@ public:
         else
         {
             root_ = std::make_unique<Node<T>>(data.at(0));
+            stats_.allocation();
             for ( int i {1}; i < data.size(); ++i )
             {
                 add(data.at(i));
@@ -130,12 +278,79 @@ public:
         Public member functions
     */
 
-    std::unique_ptr<Node<T>>&  root() { return root_; };
+    std::unique_ptr<Node<T>>&  root() { forget_ends_(); return root_; };
+    const std::unique_ptr<Node<T>>& root() const { return root_; }
 
+    /*
+        Keys larger than the maximum or not larger than the minimum are attached
+        to the cached end of the tree right away, so monotonic streams don't
+        descend the spine (amortized O(1) plus rebalancing).
+    */
     void add(T data)
     {
-        if ( !root_ ) root_ = std::make_unique<Node<T>>(data);
-        else          add_(data, root_);
+        if ( !root_ )
+        {
+            root_ = std::make_unique<Node<T>>(data);
+            leftmost_ = rightmost_ = root_.get();
+            stats_.allocation();
+            stats_.descent(1);
+            return;
+        }
+        if ( !rightmost_ )
+        {
+            leftmost_  = Cursor<T>::first(root_.get());
+            rightmost_ = Cursor<T>::last(root_.get());
+        }
+        stats_.comparison();
+        if ( rightmost_->data < data )
+        {
+            rightmost_ = attach_leaf_(data, rightmost_, false);
+            return;
+        }
+        stats_.comparison();
+        if ( data <= leftmost_->data )
+        {
+            leftmost_ = attach_leaf_(data, leftmost_, true);
+            return;
+        }
+        add_(data, root_, 1);
+    }
+
+    /*
+        Add data just before hint, like std::set::insert with a hint. If data
+        doesn't belong there, it's added as with add. A right hint costs O(1)
+        plus rebalancing. Returns an iterator at the added value.
+    */
+    InOrderIterator<T> insert_hint(InOrderIterator<T> hint, T data)
+    {
+        if ( !root_ )
+        {
+            add(data);
+            return begin();
+        }
+        Node<T>* next { hint.node() };
+        Node<T>* previous { next ? Cursor<T>::predecessor(next) : Cursor<T>::last(root_.get()) };
+        stats_.comparison();
+        bool after_previous { !previous || previous->data < data };
+        stats_.comparison();
+        bool before_next { !next || data <= next->data };
+        Node<T>* node { nullptr };
+        if ( after_previous && before_next )
+        {
+            // One of the two has a free child slot next to the gap.
+            if ( next && !next->left() ) node = attach_leaf_(data, next, true);
+            else                         node = attach_leaf_(data, previous, false);
+            if ( rightmost_ && !next )      rightmost_ = node;
+            if ( leftmost_  && !previous )  leftmost_ = node;
+        }
+        else
+        {
+            add(data);
+            // Find the new node; for duplicates any equal node will do.
+            for ( Node<T>* it { root_.get() }; it && !node; it = data < it->data ? it->left().get() : it->right().get() )
+                if ( it->data == data ) node = it;
+        }
+        return InOrderIterator<T>(node, root_.get());
     }
 
     std::optional<T> search(T key)
@@ -143,12 +358,191 @@ public:
         return search_(key, root_);
     }
 
+    /*
+        Nearest keys. Each is one descent from the root that remembers the
+        last node on the right side of the bound.
+    */
+
+    // Largest key not greater than key.
+    std::optional<T> floor(const T& key) const
+    {
+        const Node<T>* candidate { nullptr };
+        for ( const Node<T>* it { root_.get() }; it; )
+        {
+            stats_.comparison();
+            if ( key < it->data ) it = it->left().get();
+            else { candidate = it; it = it->right().get(); }
+        }
+        return candidate ? std::optional<T>(candidate->data) : std::nullopt;
+    }
+
+    // Smallest key not less than key.
+    std::optional<T> ceiling(const T& key) const
+    {
+        const Node<T>* candidate { nullptr };
+        for ( const Node<T>* it { root_.get() }; it; )
+        {
+            stats_.comparison();
+            if ( it->data < key ) it = it->right().get();
+            else { candidate = it; it = it->left().get(); }
+        }
+        return candidate ? std::optional<T>(candidate->data) : std::nullopt;
+    }
+
+    // Largest key smaller than key.
+    std::optional<T> predecessor(const T& key) const
+    {
+        const Node<T>* candidate { nullptr };
+        for ( const Node<T>* it { root_.get() }; it; )
+        {
+            stats_.comparison();
+            if ( it->data < key ) { candidate = it; it = it->right().get(); }
+            else it = it->left().get();
+        }
+        return candidate ? std::optional<T>(candidate->data) : std::nullopt;
+    }
+
+    // Smallest key larger than key.
+    std::optional<T> successor(const T& key) const
+    {
+        const Node<T>* candidate { nullptr };
+        for ( const Node<T>* it { root_.get() }; it; )
+        {
+            stats_.comparison();
+            if ( key < it->data ) { candidate = it; it = it->left().get(); }
+            else it = it->right().get();
+        }
+        return candidate ? std::optional<T>(candidate->data) : std::nullopt;
+    }
+
+    // Key closest to key, the smaller one on ties. T must support subtraction.
+    std::optional<T> nearest(const T& key) const
+    {
+        const Node<T>* below { nullptr };
+        const Node<T>* above { nullptr };
+        for ( const Node<T>* it { root_.get() }; it; )
+        {
+            stats_.comparison();
+            if ( key == it->data ) return it->data;
+            if ( key < it->data ) { above = it; it = it->left().get(); }
+            else                  { below = it; it = it->right().get(); }
+        }
+        return detail::nearer(key, below ? std::optional<T>(below->data) : std::nullopt,
+                                   above ? std::optional<T>(above->data) : std::nullopt);
+    }
+
+    // Cursor at a node equal to key, empty if there is none. The node's data may
+    // be changed in place as long as it stays equal to key.
+    Cursor<T> find(const T& key)
+    {
+        Node<T>* it { root_.get() };
+        size_t depth { 0 };
+        while ( it )
+        {
+            ++depth;
+            stats_.comparison();
+            if ( key == it->data ) break;
+            it = key < it->data ? it->left().get() : it->right().get();
+        }
+        stats_.descent(depth);
+        return Cursor<T>(it);
+    }
+
+    /*
+        Search for many keys at once, out[i] gets the result for keys[i].
+
+        A single search waits for a cache miss at every level. Here a group of
+        descents advances one level at a time in round robin, and the next node
+        of each descent is prefetched, so the loads of the whole group are in
+        flight together while the other descents do their comparisons.
+    */
+    void search_batch(std::span<const T> keys, std::span<std::optional<T>> out) const
+    {
+        if ( out.size() < keys.size() ) throw std::invalid_argument("search_batch: out is shorter than keys");
+        constexpr size_t GROUP { 16 };
+        const Node<T>* cursors[GROUP];
+        for ( size_t base {0}; base < keys.size(); base += GROUP )
+        {
+            size_t count { std::min(GROUP, keys.size() - base) };
+            for ( size_t i {0}; i < count; ++i )
+            {
+                cursors[i] = root_.get();
+                out[base + i] = std::nullopt;
+            }
+            size_t active { root_ ? count : 0 };
+            for ( size_t depth {1}; active > 0; ++depth )
+            {
+                active = 0;
+                for ( size_t i {0}; i < count; ++i )
+                {
+                    const Node<T>* it { cursors[i] };
+                    if ( !it ) continue;
+                    const T& key { keys[base + i] };
+                    stats_.comparison();
+                    if ( key == it->data )
+                    {
+                        out[base + i] = it->data;
+                        it = nullptr;
+                    }
+                    else it = key < it->data ? it->left().get() : it->right().get();
+                    cursors[i] = it;
+                    if ( it )
+                    {
+                        detail::prefetch(it);
+                        ++active;
+                    }
+                    else stats_.descent(depth);
+                }
+            }
+        }
+    }
+
+    /*
+        Search for every key of a sorted range, result i is the result for the
+        i-th key. Each search starts where the previous one ended instead of at
+        the root, so m probes cost about O(m log(n/m)) instead of O(m log n).
+        An unsorted range gives correct results, just without the speedup.
+    */
+    template<std::ranges::input_range R>
+    std::vector<std::optional<T>> search_sorted(const R& keys) const
+    {
+        std::vector<std::optional<T>> result;
+        if constexpr ( std::ranges::sized_range<R> ) result.reserve(std::ranges::size(keys));
+        const Node<T>* finger { nullptr };
+        std::optional<T> previous;
+        for ( const T& key : keys )
+        {
+            if ( previous && key < *previous ) finger = nullptr;
+            const Node<T>* found { finger_search_(key, finger) };
+            result.push_back(found ? std::optional<T>(found->data) : std::nullopt);
+            previous = key;
+        }
+        return result;
+    }
+
+    // Keys of a sorted range that are in the tree, in the order of the range.
+    template<std::ranges::input_range R>
+    std::vector<T> intersect_keys(const R& keys) const
+    {
+        std::vector<T> result;
+        const Node<T>* finger { nullptr };
+        std::optional<T> previous;
+        for ( const T& key : keys )
+        {
+            if ( previous && key < *previous ) finger = nullptr;
+            if ( finger_search_(key, finger) ) result.push_back(key);
+            previous = key;
+        }
+        return result;
+    }
+
     bool remove(T key)
     {
         // Test for nullptr is done in the auxiliary member function remove_,
         // just like in the search member function.
         // This is because it needs to be done for every node to properly handle
         // non-existing keys.
+        forget_ends_();
         return remove_(key, root_);
     }
 
@@ -166,34 +560,55 @@ public:
 
     std::optional<T> extract_max()
     {
+        forget_ends_();
         if ( !root_ ) return std::nullopt;
         return extract_max_(root_);
     }
     std::unique_ptr<Node<T>> extract_max_node()
     {
+        forget_ends_();
         if ( !root_ ) return nullptr;
+        stats_.allocation();
         return std::make_unique<Node<T>>(extract_max_(root_));
     }
 
     std::optional<T> extract_min()
     {
+        forget_ends_();
         if ( !root_ ) return std::nullopt;
         return extract_min_(root_);
     }
     std::unique_ptr<Node<T>> extract_min_node()
     {
+        forget_ends_();
         if ( !root_ ) return nullptr;
+        stats_.allocation();
         return std::make_unique<Node<T>>(extract_min_(root_));
     }
 
+    // Detach all nodes and free them on the background reclaimer thread.
+    void release_async()
+    {
+        forget_ends_();
+        Reclaimer::instance().retire(std::move(root_));
+    }
+
+    // Snapshot of instrumentation counters, all zero unless Stats counts them.
+    Counters stats() const { return stats_.snapshot(); }
+    void reset_stats() { stats_.reset(); }
+
     // Friends
 
-    template<typename K> friend void print(const BST<K>&);
+    template<typename K, typename S> friend void print(const BST<K, S>&);
 
-    template<typename K, typename F> friend void in_order(const BST<K>& tree, F fnc);
-    template<typename K, typename F> friend void pre_order(const BST<K>& tree, F fnc);
-    template<typename K, typename F> friend void post_order(const BST<K>& tree, F fnc);
-    template<typename K, typename F> friend void level_order(const BST<K>& tree, F fnc);
+    template<typename K, typename S, typename F> friend void in_order(const BST<K, S>& tree, F fnc);
+    template<typename K, typename S, typename F> friend void pre_order(const BST<K, S>& tree, F fnc);
+    template<typename K, typename S, typename F> friend void post_order(const BST<K, S>& tree, F fnc);
+    template<typename K, typename S, typename F> friend void level_order(const BST<K, S>& tree, F fnc);
+    template<typename K, typename S> friend Generator<K> in_order(const BST<K, S>& tree);
+    template<typename K, typename S> friend Generator<K> pre_order(const BST<K, S>& tree);
+    template<typename K, typename S> friend Generator<K> post_order(const BST<K, S>& tree);
+    template<typename K, typename S> friend Generator<K> level_order(const BST<K, S>& tree);
 
     // Iteration
 
@@ -206,21 +621,49 @@ public:
         return InOrderIterator<T>(nullptr);
     }
 
+    // Iterator at the smallest key not less than key, end() if there is none.
+    InOrderIterator<T> lower_bound(const T& key)
+    {
+        Node<T>* candidate { nullptr };
+        for ( Node<T>* it { root_.get() }; it; )
+        {
+            stats_.comparison();
+            if ( it->data < key ) it = it->right().get();
+            else { candidate = it; it = it->left().get(); }
+        }
+        return InOrderIterator<T>(candidate, root_.get());
+    }
+
+    // Cursor at the root, empty for an empty tree.
+    Cursor<T> cursor() { return Cursor<T>(root_.get()); }
+
 };
 
-template<typename T>
-void print(const BST<T>& tree) { print(tree.root_); }
+template<typename T, typename S>
+void print(const BST<T, S>& tree) { print(tree.root_); }
+
+template<typename T, typename S, typename F>
+void in_order(const BST<T, S>& tree, F fnc) { in_order(tree.root_, fnc); }
+
+template<typename T, typename S, typename F>
+void pre_order(const BST<T, S>& tree, F fnc) { pre_order(tree.root_, fnc); }
+
+template<typename T, typename S, typename F>
+void post_order(const BST<T, S>& tree, F fnc) { post_order(tree.root_, fnc); }
+
+template<typename T, typename S, typename F>
+void level_order(const BST<T, S>& tree, F fnc) { level_order(tree.root_, fnc); }
 
-template<typename T, typename F>
-void in_order(const BST<T>& tree, F fnc) { in_order(tree.root_, fnc); }
+template<typename T, typename S>
+Generator<T> in_order(const BST<T, S>& tree) { return in_order(tree.root_); }
 
-template<typename T, typename F>
-void pre_order(const BST<T>& tree, F fnc) { pre_order(tree.root_, fnc); }
+template<typename T, typename S>
+Generator<T> pre_order(const BST<T, S>& tree) { return pre_order(tree.root_); }
 
-template<typename T, typename F>
-void post_order(const BST<T>& tree, F fnc) { post_order(tree.root_, fnc); }
+template<typename T, typename S>
+Generator<T> post_order(const BST<T, S>& tree) { return post_order(tree.root_); }
 
-template<typename T, typename F>
-void level_order(const BST<T>& tree, F fnc) { level_order(tree.root_, fnc); }
+template<typename T, typename S>
+Generator<T> level_order(const BST<T, S>& tree) { return level_order(tree.root_); }
 
 }  // namespace tree
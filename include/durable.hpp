@@ -0,0 +1,287 @@
+#pragma once
+
+#include <charconv>
+#include <filesystem>
+#include <memory>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "linked.hpp"
+#include "trace.hpp"
+
+
+namespace tree
+{
+
+/*
+    Write-ahead log and snapshots for a BST or AVL with integer keys.
+
+    Every add and remove made through Durable is appended to a log in the
+    trace encoding (see trace.hpp). Records are collected in memory and
+    written together, group records at a time or on commit(), so the cost of
+    a write to the file is shared by the whole group. checkpoint() writes a
+    snapshot of the tree with serialize and empties the log.
+
+    On construction the tree is recovered from the files: the snapshot is
+    loaded, the log is replayed in batches, and a new checkpoint replaces
+    both. A record cut short by a crash ends the replay.
+
+    Snapshot and log are numbered by generation: the snapshot starts with
+    its generation g and the log of changes made after it is path.g.wal. A
+    crash during checkpoint leaves either the old snapshot with its log, or
+    the new snapshot whose log doesn't exist yet, never a log replayed twice.
+    Logs older than the snapshot are removed on construction.
+
+        tree::AVL<int> search_tree;
+        tree::Durable durable { search_tree, "data/index" };   // data/index.snap, data/index.1.wal
+        durable.add(7);
+        durable.commit();
+
+    commit() hands records to the operating system, it doesn't sync the disk.
+    Records not yet committed are lost on a crash.
+*/
+template<typename Tree>
+class Durable
+{
+public:
+
+    using key_type = std::remove_cvref_t<decltype(*std::declval<Tree&>().min())>;
+
+    // Events replayed at once during recovery.
+    static constexpr size_t REPLAY_BATCH { 4096 };
+
+private:
+
+    Tree& tree_;
+    std::filesystem::path path_;
+    std::filesystem::path snapshot_path_;
+    size_t generation_ { 0 };
+    size_t group_;
+
+    std::ofstream log_;
+    std::ostringstream pending_;
+    std::optional<TraceWriter<key_type>> writer_;
+    size_t pending_count_ { 0 };
+
+    /*
+        Read a subtree of the snapshot. Like deserialize, but keys are parsed
+        as key_type, not int, and heights are restored as AVL needs them.
+    */
+    std::unique_ptr<Node<key_type>> read_snapshot_(std::istream& in) const
+    {
+        std::string token;
+        if ( !(in >> token) ) throw std::runtime_error("Durable: truncated snapshot " + snapshot_path_.string());
+        if ( token == "#" ) return nullptr;
+        key_type key {};
+        auto [end, error] { std::from_chars(token.data(), token.data() + token.size(), key) };
+        if ( error != std::errc() || end != token.data() + token.size() )
+            throw std::runtime_error("Durable: invalid key in snapshot " + snapshot_path_.string());
+        auto node { std::make_unique<Node<key_type>>(key) };
+        node->left(read_snapshot_(in));
+        node->right(read_snapshot_(in));
+        update_height(node);
+        return node;
+    }
+
+    void apply_(const Event<key_type>& event)
+    {
+        switch ( event.op )
+        {
+        case Op::add:         tree_.add(event.key); break;
+        case Op::remove:      tree_.remove(event.key); break;
+        case Op::extract_min: tree_.extract_min(); break;
+        case Op::extract_max: tree_.extract_max(); break;
+        default:              break;
+        }
+    }
+
+    std::filesystem::path log_path_(size_t generation) const
+    {
+        return path_.string() + "." + std::to_string(generation) + ".wal";
+    }
+
+    void load_snapshot_()
+    {
+        std::ifstream in { snapshot_path_ };
+        if ( !in ) return;
+        if ( !(in >> generation_) ) throw std::runtime_error("Durable: invalid snapshot " + snapshot_path_.string());
+        tree_.root() = read_snapshot_(in);
+    }
+
+    // Remove logs of generations before the snapshot, left by a crash during checkpoint.
+    void remove_old_logs_() const
+    {
+        std::filesystem::path directory { path_.has_parent_path() ? path_.parent_path() : std::filesystem::path{"."} };
+        std::string prefix { path_.filename().string() + "." };
+        std::error_code error;
+        for ( const auto& entry : std::filesystem::directory_iterator(directory, error) )
+        {
+            std::string name { entry.path().filename().string() };
+            if ( !name.starts_with(prefix) || !name.ends_with(".wal") ) continue;
+            std::string number { name.substr(prefix.size(), name.size() - prefix.size() - 4) };
+            size_t generation { 0 };
+            auto [end, parsed] { std::from_chars(number.data(), number.data() + number.size(), generation) };
+            if ( parsed == std::errc() && end == number.data() + number.size() && !number.empty() && generation < generation_ )
+                std::filesystem::remove(entry.path(), error);
+        }
+    }
+
+    void replay_log_()
+    {
+        std::error_code error;
+        // A log without the complete header was never committed to.
+        if ( std::filesystem::file_size(log_path_(generation_), error) < 5 || error ) return;
+        std::ifstream in { log_path_(generation_), std::ios::binary };
+        TraceReader<key_type> reader { in };
+        std::vector<Event<key_type>> batch;
+        batch.reserve(REPLAY_BATCH);
+        bool more { true };
+        while ( more )
+        {
+            batch.clear();
+            try
+            {
+                while ( batch.size() < REPLAY_BATCH )
+                {
+                    auto event { reader.next() };
+                    if ( !event ) { more = false; break; }
+                    batch.push_back(*event);
+                }
+            }
+            catch ( const std::runtime_error& )
+            {
+                // Torn last record.
+                more = false;
+            }
+            for ( const Event<key_type>& event : batch ) apply_(event);
+        }
+    }
+
+    // Start an empty log of the current generation, remove the previous one.
+    void reset_log_()
+    {
+        log_.close();
+        log_.open(log_path_(generation_), std::ios::binary | std::ios::trunc);
+        if ( !log_ ) throw std::runtime_error("Durable: cannot open " + log_path_(generation_).string());
+        if ( generation_ > 0 ) std::filesystem::remove(log_path_(generation_ - 1));
+        pending_.str("");
+        pending_count_ = 0;
+        writer_.emplace(pending_);
+        commit();
+    }
+
+    void record_(Op op, key_type key = {})
+    {
+        writer_->write(op, key);
+        if ( ++pending_count_ >= group_ ) commit();
+    }
+
+public:
+
+    /*
+        Constructors
+    */
+
+    // Recover tree from path.snap and its log, then checkpoint. Commit every group records.
+    Durable(Tree& tree, const std::filesystem::path& path, size_t group = 64)
+        : tree_{tree}, path_{path}, snapshot_path_{path.string() + ".snap"}, group_{group ? group : 1}
+    {
+        load_snapshot_();
+        remove_old_logs_();
+        replay_log_();
+        checkpoint();
+    }
+
+    Durable(const Durable& other) = delete;
+    Durable& operator=(const Durable& other) = delete;
+
+    ~Durable()
+    {
+        try { commit(); }
+        catch ( ... ) {}
+    }
+
+    /*
+        Public member functions
+    */
+
+    void add(key_type key)
+    {
+        tree_.add(key);
+        record_(Op::add, key);
+    }
+
+    bool remove(key_type key)
+    {
+        bool removed { tree_.remove(key) };
+        if ( removed ) record_(Op::remove, key);
+        return removed;
+    }
+
+    std::optional<key_type> extract_min()
+    {
+        auto key { tree_.extract_min() };
+        if ( key ) record_(Op::extract_min);
+        return key;
+    }
+
+    std::optional<key_type> extract_max()
+    {
+        auto key { tree_.extract_max() };
+        if ( key ) record_(Op::extract_max);
+        return key;
+    }
+
+    // Not logged.
+    std::optional<key_type> search(key_type key) { return tree_.search(key); }
+
+    // Write collected records to the log.
+    void commit()
+    {
+        std::string records { pending_.str() };
+        if ( records.empty() ) return;
+        log_.write(records.data(), static_cast<std::streamsize>(records.size()));
+        log_.flush();
+        if ( !log_ ) throw std::runtime_error("Durable: cannot write " + log_path_(generation_).string());
+        pending_.str("");
+        pending_count_ = 0;
+    }
+
+    /*
+        Write a snapshot of the tree and start the log of the next generation.
+        The snapshot goes to a temporary file first and replaces the old one
+        by rename.
+    */
+    void checkpoint()
+    {
+        commit();
+        std::filesystem::path temporary { snapshot_path_.string() + ".tmp" };
+        {
+            std::ofstream out { temporary, std::ios::trunc };
+            out << generation_ + 1 << ' ';
+            serialize(tree_.root(), out);
+            out.flush();
+            if ( !out ) throw std::runtime_error("Durable: cannot write " + temporary.string());
+        }
+        std::filesystem::rename(temporary, snapshot_path_);
+        ++generation_;
+        reset_log_();
+    }
+
+    // Generation of the last snapshot.
+    size_t generation() const { return generation_; }
+
+    // Records not yet committed.
+    size_t pending() const { return pending_count_; }
+
+    Tree& tree() { return tree_; }
+
+};
+
+}  // namespace tree
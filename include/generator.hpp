@@ -0,0 +1,121 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <utility>
+
+
+namespace tree
+{
+
+/*
+    Lazy sequence of references produced by a coroutine.
+
+    The coroutine runs only when the consumer asks for the next value, so
+    breaking out of a loop over a generator (or taking a prefix with
+    std::views::take) stops the work. A generator is a view, it composes with
+    std::ranges views without copying values into a container.
+
+        for ( const int& key : tree::in_order(search_tree) | std::views::take(10) )
+            ...
+
+    Values are yielded by reference and stay valid until the generator is
+    advanced. A generator can be iterated once.
+*/
+template<typename T>
+class Generator : public std::ranges::view_base
+{
+public:
+
+    struct promise_type
+    {
+        const T* value_ { nullptr };
+        std::exception_ptr exception_;
+
+        Generator get_return_object()
+        {
+            return Generator { std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(const T& value) noexcept
+        {
+            value_ = std::addressof(value);
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception() { exception_ = std::current_exception(); }
+
+        // Generators only yield.
+        void await_transform() = delete;
+    };
+
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    class Iterator
+    {
+    private:
+
+        handle_type handle_ { nullptr };
+
+    public:
+
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() {}
+        explicit Iterator(handle_type handle) : handle_{handle} {}
+
+        const T& operator*() const { return *handle_.promise().value_; }
+        const T* operator->() const { return handle_.promise().value_; }
+
+        Iterator& operator++()
+        {
+            handle_.resume();
+            if ( handle_.done() && handle_.promise().exception_ )
+                std::rethrow_exception(handle_.promise().exception_);
+            return *this;
+        }
+        void operator++(int) { ++(*this); }
+
+        bool operator==(std::default_sentinel_t) const { return !handle_ || handle_.done(); }
+    };
+
+private:
+
+    handle_type handle_ { nullptr };
+
+    explicit Generator(handle_type handle) : handle_{handle} {}
+
+public:
+
+    Generator() {}
+    Generator(const Generator& other) = delete;
+    Generator& operator=(const Generator& other) = delete;
+    Generator(Generator&& other) noexcept : handle_{std::exchange(other.handle_, nullptr)} {}
+    Generator& operator=(Generator&& other) noexcept
+    {
+        if ( this != &other )
+        {
+            if ( handle_ ) handle_.destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+    ~Generator() { if ( handle_ ) handle_.destroy(); }
+
+    // Runs the coroutine to its first value.
+    Iterator begin()
+    {
+        Iterator it { handle_ };
+        if ( handle_ ) ++it;
+        return it;
+    }
+    std::default_sentinel_t end() const { return {}; }
+
+};
+
+}  // namespace tree
@@ -0,0 +1,422 @@
+#pragma once
+
+#include <iostream>
+#include <array>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <bit>
+
+#include "linked.hpp"
+
+
+namespace tree
+{
+namespace huffman
+{
+
+/*
+    Huffman coding of bytes.
+
+    The Huffman tree is built from Node objects. Internal nodes hold only the
+    combined weight of their subtree, leaves hold a symbol and its weight.
+    The tree is used only to find the code length of every symbol. Codes are
+    then assigned canonically, so that the code lengths alone describe the
+    code. Decoding does not walk the tree bit by bit, it looks up a whole
+    MAX_BITS wide window of the input in a table that gives the symbol and the
+    length of its code.
+
+    Data are coded in independent blocks, so streams of any size are handled
+    with bounded memory. Block layout (integers little endian):
+
+        u32 raw_size          Number of coded bytes, 0 ends the stream.
+        u8  lengths[128]      Code lengths of 256 symbols, two per byte.
+        u32 payload_size      Number of bytes of coded data.
+        u8  payload[payload_size]
+*/
+
+constexpr unsigned MAX_BITS { 11 };                  // Longest allowed code.
+constexpr size_t   BLOCK_SIZE { size_t{1} << 20 };   // Default block size, 1 MiB.
+
+using Frequencies = std::array<std::uint64_t, 256>;
+using Lengths = std::array<std::uint8_t, 256>;
+
+struct Symbol
+{
+    std::uint64_t weight;
+    int symbol { -1 };  // -1 for internal nodes.
+
+    auto operator<=>(const Symbol& other) const
+    {
+        return weight <=> other.weight;
+    }
+    bool operator==(const Symbol& other) const
+    {
+        return weight == other.weight;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const Symbol& obj)
+{
+    return os << "(" << obj.symbol << " " << obj.weight << ")";
+}
+
+struct Code
+{
+    std::uint32_t bits { 0 };
+    std::uint8_t length { 0 };
+};
+
+// Add frequencies of bytes in data to freq.
+inline void count_frequencies(const std::uint8_t* data, size_t size, Frequencies& freq)
+{
+    // Four interleaved tables avoid stalls on repeated increments of the same counter.
+    std::array<std::array<std::uint32_t, 256>, 4> partial {};
+    size_t i { 0 };
+    for ( ; i + 4 <= size; i += 4 )
+    {
+        ++partial[0][data[i]];
+        ++partial[1][data[i + 1]];
+        ++partial[2][data[i + 2]];
+        ++partial[3][data[i + 3]];
+    }
+    for ( ; i < size; ++i ) ++partial[0][data[i]];
+    for ( int s {0}; s < 256; ++s )
+        freq[s] += std::uint64_t{partial[0][s]} + partial[1][s] + partial[2][s] + partial[3][s];
+}
+
+inline Frequencies count_frequencies(const std::uint8_t* data, size_t size)
+{
+    Frequencies freq {};
+    count_frequencies(data, size, freq);
+    return freq;
+}
+
+/*
+    Build Huffman tree by repeatedly joining two lightest subtrees, taken from a
+    priority queue. Returns nullptr if there are no symbols.
+*/
+inline std::unique_ptr<Node<Symbol>> build_tree(const Frequencies& freq)
+{
+    using entry_t = std::pair<std::uint64_t, std::unique_ptr<Node<Symbol>>>;  // Order of creation, node.
+    std::uint64_t order { 0 };
+    // Min-heap by weight, ties broken by order of creation to keep the tree deterministic.
+    auto heavier = [](const entry_t& lhs, const entry_t& rhs)
+    {
+        if ( lhs.second->data.weight != rhs.second->data.weight )
+            return lhs.second->data.weight > rhs.second->data.weight;
+        return lhs.first > rhs.first;
+    };
+    std::vector<entry_t> heap;
+    for ( int s {0}; s < 256; ++s )
+    {
+        if ( freq[s] == 0 ) continue;
+        heap.emplace_back(order++, std::make_unique<Node<Symbol>>(Symbol{freq[s], s}));
+    }
+    if ( heap.empty() ) return nullptr;
+    std::make_heap(heap.begin(), heap.end(), heavier);
+    auto pop = [&]()
+    {
+        std::pop_heap(heap.begin(), heap.end(), heavier);
+        auto node { std::move(heap.back().second) };
+        heap.pop_back();
+        return node;
+    };
+    while ( heap.size() > 1 )
+    {
+        auto first  { pop() };
+        auto second { pop() };
+        auto parent { std::make_unique<Node<Symbol>>(Symbol{first->data.weight + second->data.weight}) };
+        parent->left(std::move(first));
+        parent->right(std::move(second));
+        heap.emplace_back(order++, std::move(parent));
+        std::push_heap(heap.begin(), heap.end(), heavier);
+    }
+    return std::move(heap.front().second);
+}
+
+namespace detail
+{
+
+inline void code_lengths_(const std::unique_ptr<Node<Symbol>>& node, unsigned depth, std::vector<unsigned>& lengths)
+{
+    if ( !node ) return;
+    if ( node->degree() == Degree::none )
+    {
+        lengths[node->data.symbol] = std::max(depth, 1u);   // Lone symbol still needs one bit.
+        return;
+    }
+    code_lengths_(node->left(), depth + 1, lengths);
+    code_lengths_(node->right(), depth + 1, lengths);
+}
+
+}  // namespace detail
+
+/*
+    Lengths of codes of a Huffman tree, limited to max_bits.
+
+    Codes longer than max_bits are cut to max_bits. The code is then no longer
+    decodable (Kraft sum exceeds one), so codes of the rarest symbols that are
+    still shorter than max_bits are made longer until the sum fits again.
+*/
+inline Lengths code_lengths(const std::unique_ptr<Node<Symbol>>& root, const Frequencies& freq,
+                            unsigned max_bits = MAX_BITS)
+{
+    std::vector<unsigned> depth(256, 0);
+    detail::code_lengths_(root, 0, depth);
+
+    const std::uint64_t capacity { std::uint64_t{1} << max_bits };
+    std::uint64_t kraft { 0 };
+    for ( auto& length : depth )
+    {
+        if ( length == 0 ) continue;
+        length = std::min(length, max_bits);
+        kraft += std::uint64_t{1} << (max_bits - length);
+    }
+    if ( kraft > capacity )
+    {
+        // Symbols from the rarest to the most frequent.
+        std::vector<int> order;
+        for ( int s {0}; s < 256; ++s ) if ( depth[s] ) order.push_back(s);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return freq[a] < freq[b]; });
+        while ( kraft > capacity )
+        {
+            // Longest code that can still grow costs the least.
+            int best { -1 };
+            for ( int s : order )
+                if ( depth[s] < max_bits && (best < 0 || depth[s] > depth[best]) ) best = s;
+            kraft -= std::uint64_t{1} << (max_bits - depth[best] - 1);
+            ++depth[best];
+        }
+    }
+
+    Lengths lengths {};
+    for ( int s {0}; s < 256; ++s ) lengths[s] = static_cast<std::uint8_t>(depth[s]);
+    return lengths;
+}
+
+// Canonical codes: shorter codes first, codes of the same length ordered by symbol.
+inline std::array<Code, 256> canonical_codes(const Lengths& lengths)
+{
+    std::array<unsigned, 32> count {};
+    for ( auto length : lengths ) ++count[length];
+    count[0] = 0;
+    std::array<std::uint32_t, 32> next {};
+    std::uint32_t code { 0 };
+    for ( unsigned length {1}; length < 32; ++length )
+    {
+        code = (code + count[length - 1]) << 1;
+        next[length] = code;
+    }
+    std::array<Code, 256> codes {};
+    for ( int s {0}; s < 256; ++s )
+    {
+        if ( lengths[s] == 0 ) continue;
+        codes[s] = Code{ next[lengths[s]]++, lengths[s] };
+    }
+    return codes;
+}
+
+class Encoder
+{
+private:
+
+    std::array<Code, 256> codes_;
+
+public:
+
+    explicit Encoder(const Lengths& lengths) : codes_{canonical_codes(lengths)} {}
+
+    // Append coded data to out. Bits are written from the most significant bit.
+    void encode(const std::uint8_t* data, size_t size, std::vector<std::uint8_t>& out) const
+    {
+        size_t position { out.size() };
+        out.resize(position + size * MAX_BITS / 8 + 8);
+        std::uint8_t* it { out.data() + position };
+        std::uint64_t buffer { 0 };
+        unsigned count { 0 };
+        for ( size_t i {0}; i < size; ++i )
+        {
+            const Code& code { codes_[data[i]] };
+            buffer = (buffer << code.length) | code.bits;
+            count += code.length;
+            if ( count >= 32 )
+            {
+                // Flush four whole bytes.
+                std::uint32_t word { static_cast<std::uint32_t>(buffer >> (count - 32)) };
+                it[0] = static_cast<std::uint8_t>(word >> 24);
+                it[1] = static_cast<std::uint8_t>(word >> 16);
+                it[2] = static_cast<std::uint8_t>(word >> 8);
+                it[3] = static_cast<std::uint8_t>(word);
+                it += 4;
+                count -= 32;
+            }
+        }
+        while ( count >= 8 )
+        {
+            *it++ = static_cast<std::uint8_t>(buffer >> (count - 8));
+            count -= 8;
+        }
+        if ( count > 0 ) *it++ = static_cast<std::uint8_t>(buffer << (8 - count));
+        out.resize(static_cast<size_t>(it - out.data()));
+    }
+
+};
+
+class Decoder
+{
+private:
+
+    struct Entry
+    {
+        std::uint8_t symbol { 0 };
+        std::uint8_t length { 0 };  // 0 marks a window that no code starts with.
+    };
+
+    std::array<Entry, size_t{1} << MAX_BITS> table_ {};
+
+public:
+
+    explicit Decoder(const Lengths& lengths)
+    {
+        auto codes { canonical_codes(lengths) };
+        for ( int s {0}; s < 256; ++s )
+        {
+            const Code& code { codes[s] };
+            if ( code.length == 0 ) continue;
+            if ( code.length > MAX_BITS ) throw std::runtime_error("huffman: code too long");
+            // Every window starting with this code decodes to this symbol.
+            size_t first { size_t{code.bits} << (MAX_BITS - code.length) };
+            size_t last  { first + (size_t{1} << (MAX_BITS - code.length)) };
+            if ( last > table_.size() ) throw std::runtime_error("huffman: invalid code lengths");
+            for ( size_t i {first}; i < last; ++i ) table_[i] = Entry{ static_cast<std::uint8_t>(s), code.length };
+        }
+    }
+
+    // Decode count symbols from data into out.
+    void decode(const std::uint8_t* data, size_t size, std::uint8_t* out, size_t count) const
+    {
+        const std::uint8_t* end { data + size };
+        std::uint64_t buffer { 0 };  // Valid bits are aligned to the most significant bit.
+        int bits { 0 };
+        for ( size_t i {0}; i < count; ++i )
+        {
+            if ( bits < static_cast<int>(MAX_BITS) )
+            {
+                if ( end - data >= 8 )
+                {
+                    // Fast refill: top up the buffer with whole bytes of one unaligned load.
+                    std::uint64_t word;
+                    std::memcpy(&word, data, 8);
+                    if constexpr ( std::endian::native == std::endian::little ) word = byteswap_(word);
+                    unsigned take { static_cast<unsigned>(63 - bits) / 8 };
+                    buffer |= (word >> bits) & ~(~std::uint64_t{0} >> (bits + 8 * take));
+                    data += take;
+                    bits += 8 * take;
+                }
+                else
+                {
+                    while ( bits <= 56 && data < end )
+                    {
+                        buffer |= std::uint64_t{*data++} << (56 - bits);
+                        bits += 8;
+                    }
+                }
+            }
+            const Entry& entry { table_[buffer >> (64 - MAX_BITS)] };
+            if ( entry.length == 0 )   throw std::runtime_error("huffman: corrupted data");
+            if ( entry.length > bits ) throw std::runtime_error("huffman: unexpected end of data");
+            out[i] = entry.symbol;
+            buffer <<= entry.length;
+            bits -= entry.length;
+        }
+    }
+
+private:
+
+    static std::uint64_t byteswap_(std::uint64_t value)
+    {
+        value = ((value & 0x00FF00FF00FF00FFull) << 8)  | ((value >> 8)  & 0x00FF00FF00FF00FFull);
+        value = ((value & 0x0000FFFF0000FFFFull) << 16) | ((value >> 16) & 0x0000FFFF0000FFFFull);
+        return (value << 32) | (value >> 32);
+    }
+
+};
+
+namespace detail
+{
+
+inline void write_u32_(std::ostream& out, std::uint32_t value)
+{
+    char bytes[4] { static_cast<char>(value), static_cast<char>(value >> 8),
+                    static_cast<char>(value >> 16), static_cast<char>(value >> 24) };
+    out.write(bytes, 4);
+}
+
+inline bool read_u32_(std::istream& in, std::uint32_t& value)
+{
+    unsigned char bytes[4];
+    if ( !in.read(reinterpret_cast<char*>(bytes), 4) ) return false;
+    value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (std::uint32_t{bytes[3]} << 24);
+    return true;
+}
+
+}  // namespace detail
+
+// Compress the whole input stream into the output stream.
+inline void compress(std::istream& in, std::ostream& out, size_t block_size = BLOCK_SIZE)
+{
+    std::vector<std::uint8_t> block(block_size);
+    std::vector<std::uint8_t> coded;
+    while ( true )
+    {
+        in.read(reinterpret_cast<char*>(block.data()), static_cast<std::streamsize>(block.size()));
+        size_t size { static_cast<size_t>(in.gcount()) };
+        if ( size == 0 ) break;
+
+        auto freq { count_frequencies(block.data(), size) };
+        auto lengths { code_lengths(build_tree(freq), freq) };
+        coded.clear();
+        Encoder(lengths).encode(block.data(), size, coded);
+
+        detail::write_u32_(out, static_cast<std::uint32_t>(size));
+        for ( int s {0}; s < 256; s += 2 )
+            out.put(static_cast<char>(lengths[s] | (lengths[s + 1] << 4)));
+        detail::write_u32_(out, static_cast<std::uint32_t>(coded.size()));
+        out.write(reinterpret_cast<const char*>(coded.data()), static_cast<std::streamsize>(coded.size()));
+    }
+    detail::write_u32_(out, 0);
+}
+
+// Decompress a stream written by compress.
+inline void decompress(std::istream& in, std::ostream& out)
+{
+    std::vector<std::uint8_t> coded;
+    std::vector<std::uint8_t> block;
+    std::uint32_t size;
+    while ( detail::read_u32_(in, size) && size != 0 )
+    {
+        Lengths lengths {};
+        for ( int s {0}; s < 256; s += 2 )
+        {
+            int packed { in.get() };
+            if ( packed == std::char_traits<char>::eof() ) throw std::runtime_error("huffman: truncated header");
+            lengths[s]     = static_cast<std::uint8_t>(packed & 0x0F);
+            lengths[s + 1] = static_cast<std::uint8_t>(packed >> 4);
+        }
+        std::uint32_t payload;
+        if ( !detail::read_u32_(in, payload) ) throw std::runtime_error("huffman: truncated header");
+        coded.resize(payload);
+        if ( !in.read(reinterpret_cast<char*>(coded.data()), payload) )
+            throw std::runtime_error("huffman: truncated block");
+        block.resize(size);
+        Decoder(lengths).decode(coded.data(), coded.size(), block.data(), size);
+        out.write(reinterpret_cast<const char*>(block.data()), size);
+    }
+}
+
+}  // namespace huffman
+}  // namespace tree
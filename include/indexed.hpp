@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "linked.hpp"
+#include "loader.hpp"
+
+
+namespace tree
+{
+
+/*
+    Parallel loading of serialized trees through a sidecar index.
+
+    A pre-order serialization can only be read from the start: where the
+    right subtree begins is known once the left one is parsed. So
+    serialize_indexed writes, next to the usual serialize text file, an
+    index (path + ".idx") with the byte range of every subtree rooted in the
+    top levels of the tree. load_tree_parallel reads the index, creates the
+    nodes above the cut level from the first token of their ranges, builds
+    the subtrees at the cut level on several threads, each reading its own
+    range of the file, and hangs them under their parents.
+
+    Index layout:
+        "TIX1"        magic
+        u32           cut level d, the root is at level 0
+        u64           size of the text file
+        entries       u64 offset, u64 length; for heap positions 1 .. 2^(d+1) - 1
+                      (root 1, children of p at 2p and 2p + 1), length 0 if there's no node
+    Numbers are stored in the byte order of the machine.
+
+        tree::serialize_indexed(root, "data/big.tr");          // data/big.tr, data/big.tr.idx
+        auto copy { tree::load_tree_parallel<int>("data/big.tr") };
+
+    The text file stays readable by deserialize and load_tree.
+*/
+
+struct SubtreeRange
+{
+    std::uint64_t offset { 0 };
+    std::uint64_t length { 0 };
+};
+
+namespace detail
+{
+
+template<typename T>
+void serialize_indexed_(const std::unique_ptr<Node<T>>& node, std::ostream& out,
+                        std::vector<SubtreeRange>& index, size_t position, size_t level, size_t cut)
+{
+    if ( !node )
+    {
+        out << "# ";
+        return;
+    }
+    std::uint64_t start { static_cast<std::uint64_t>(out.tellp()) };
+    if ( level == cut ) serialize(node, out);
+    else
+    {
+        out << node->data << " ";
+        serialize_indexed_(node->left(), out, index, 2 * position, level + 1, cut);
+        serialize_indexed_(node->right(), out, index, 2 * position + 1, level + 1, cut);
+    }
+    index[position] = { start, static_cast<std::uint64_t>(out.tellp()) - start };
+}
+
+// Read length bytes of in at offset, false if it's shorter.
+inline bool read_range(std::istream& in, std::uint64_t offset, std::uint64_t length, std::vector<char>& bytes)
+{
+    bytes.resize(length);
+    in.clear();
+    in.seekg(static_cast<std::streamoff>(offset));
+    return static_cast<bool>(in.read(bytes.data(), static_cast<std::streamsize>(length)));
+}
+
+// Tree serialized in bytes, nullopt unless they hold exactly one complete tree. Throws std::runtime_error for an invalid token.
+template<typename T>
+std::optional<std::unique_ptr<Node<T>>> build_range(const std::vector<char>& bytes)
+{
+    PreorderBuilder<T> builder;
+    const char* it { bytes.data() };
+    const char* end { it + bytes.size() };
+    auto space { [](char c){ return c == ' ' || c == '\n' || c == '\r' || c == '\t'; } };
+    while ( it != end )
+    {
+        while ( it != end && space(*it) ) ++it;
+        const char* first { it };
+        while ( it != end && !space(*it) ) ++it;
+        if ( first == it ) break;
+        if ( builder.complete() ) return std::nullopt;   // Tokens after the tree.
+        T value {};
+        bool null { !parse_token(first, it, value) };
+        builder.add(null, value);
+    }
+    if ( !builder.complete() ) return std::nullopt;
+    return builder.release();
+}
+
+}  // namespace detail
+
+/*
+    Write the tree like serialize to path, and the index of subtrees of its
+    top cut levels to path + ".idx". 2^cut subtrees can load in parallel.
+*/
+template<typename T>
+void serialize_indexed(const std::unique_ptr<Node<T>>& root, const std::filesystem::path& path, size_t cut = 6)
+{
+    std::vector<SubtreeRange> index(size_t{2} << cut);   // Position 0 is unused.
+    std::uint64_t size { 0 };
+    {
+        std::ofstream out { path, std::ios::binary | std::ios::trunc };
+        if ( !out ) throw std::runtime_error("serialize_indexed: cannot open " + path.string());
+        detail::serialize_indexed_(root, out, index, 1, 0, cut);
+        size = static_cast<std::uint64_t>(out.tellp());
+        if ( !out ) throw std::runtime_error("serialize_indexed: cannot write " + path.string());
+    }
+    std::ofstream out { path.string() + ".idx", std::ios::binary | std::ios::trunc };
+    std::uint32_t levels { static_cast<std::uint32_t>(cut) };
+    out.write("TIX1", 4);
+    out.write(reinterpret_cast<const char*>(&levels), sizeof(levels));
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(reinterpret_cast<const char*>(index.data() + 1), static_cast<std::streamsize>((index.size() - 1) * sizeof(SubtreeRange)));
+    if ( !out ) throw std::runtime_error("serialize_indexed: cannot write " + path.string() + ".idx");
+}
+
+/*
+    Load a tree written by serialize_indexed, building the subtrees at the
+    cut level on threads threads (0 for one per core).
+
+    The index is trusted only as far as the file agrees with it: the root
+    range must cover the whole file, a node above the cut must be its key
+    followed by the ranges of its children ("# " for no child), and a range
+    at the cut must hold exactly one tree. The loaded tree then is the one
+    the file holds, whatever the index was written for. Without an index,
+    or with one the file doesn't agree with, falls back to load_tree, which
+    throws std::runtime_error for a file that can't be parsed.
+*/
+template<typename T>
+requires std::is_arithmetic_v<T>
+std::unique_ptr<Node<T>> load_tree_parallel(const std::filesystem::path& path, size_t threads = 0)
+{
+    std::ifstream index_file { path.string() + ".idx", std::ios::binary };
+    char magic[4] {};
+    std::uint32_t cut { 0 };
+    std::uint64_t size { 0 };
+    index_file.read(magic, 4);
+    index_file.read(reinterpret_cast<char*>(&cut), sizeof(cut));
+    index_file.read(reinterpret_cast<char*>(&size), sizeof(size));
+    std::error_code error;
+    if ( !index_file || std::memcmp(magic, "TIX1", 4) != 0 || cut > 30
+         || std::filesystem::file_size(path, error) != size || error )
+        return load_tree<T>(path);
+    std::vector<SubtreeRange> index(size_t{2} << cut);
+    if ( !index_file.read(reinterpret_cast<char*>(index.data() + 1), static_cast<std::streamsize>((index.size() - 1) * sizeof(SubtreeRange))) )
+        return load_tree<T>(path);
+
+    // An empty tree has nothing to split. Every other subtree hangs under a node.
+    bool valid { index[1].length != 0 && index[1].offset == 0 && index[1].length == size };
+    for ( size_t position {2}; valid && position < index.size(); ++position )
+        valid = !index[position].length || index[position / 2].length;
+    if ( !valid ) return load_tree<T>(path);
+
+    // Nodes above the cut, by heap position.
+    const size_t first_cut { size_t{1} << cut };
+    std::vector<std::unique_ptr<Node<T>>> top(first_cut);
+    std::ifstream text { path, std::ios::binary };
+    std::vector<char> bytes;
+    for ( size_t position {1}; valid && position < first_cut; ++position )
+    {
+        const SubtreeRange& range { index[position] };
+        if ( !range.length ) continue;
+        T value {};
+        valid = detail::read_range(text, range.offset, std::min<std::uint64_t>(range.length, 64), bytes);
+        auto key_end { std::find(bytes.begin(), bytes.end(), ' ') };
+        try
+        {
+            valid = valid && key_end != bytes.end() && detail::parse_token(bytes.data(), bytes.data() + (key_end - bytes.begin()), value);
+        }
+        catch ( const std::runtime_error& ) { valid = false; }
+        if ( !valid ) break;
+        std::uint64_t next { range.offset + static_cast<std::uint64_t>(key_end - bytes.begin()) + 1 };
+        for ( size_t child : { 2 * position, 2 * position + 1 } )
+        {
+            if ( index[child].length ) valid = valid && index[child].offset == next;
+            else valid = valid && detail::read_range(text, next, 2, bytes) && bytes[0] == '#' && bytes[1] == ' ';
+            next += index[child].length ? index[child].length : 2;
+        }
+        valid = valid && next == range.offset + range.length;
+        top[position] = std::make_unique<Node<T>>(value);
+    }
+    if ( !valid ) return load_tree<T>(path);
+
+    // Subtrees at the cut, built in parallel.
+    std::vector<std::unique_ptr<Node<T>>> subtrees(first_cut);
+    std::atomic<size_t> next { 0 };
+    std::atomic<bool> failed { false };
+    auto work { [&]{
+        std::ifstream in { path, std::ios::binary };
+        std::vector<char> range_bytes;
+        for ( size_t i; !failed.load(std::memory_order_relaxed) && (i = next.fetch_add(1)) < first_cut; )
+        {
+            const SubtreeRange& range { index[first_cut + i] };
+            if ( !range.length ) continue;
+            try
+            {
+                std::optional<std::unique_ptr<Node<T>>> subtree;
+                if ( detail::read_range(in, range.offset, range.length, range_bytes) ) subtree = detail::build_range<T>(range_bytes);
+                if ( subtree ) subtrees[i] = std::move(*subtree);
+                else           failed = true;
+            }
+            catch ( ... ) { failed = true; }
+        }
+    } };
+    if ( threads == 0 ) threads = std::max(1u, std::thread::hardware_concurrency());
+    {
+        std::vector<std::jthread> workers;
+        for ( size_t t {1}; t < std::min<size_t>(threads, first_cut); ++t ) workers.emplace_back(work);
+        work();
+    }
+    if ( failed ) return load_tree<T>(path);
+    if ( cut == 0 ) return std::move(subtrees[0]);
+
+    // Hang everything under its parent, bottom up.
+    for ( size_t i {0}; i < first_cut; ++i )
+    {
+        if ( !subtrees[i] ) continue;
+        size_t position { first_cut + i };
+        if ( position % 2 ) top[position / 2]->right(std::move(subtrees[i]));
+        else                top[position / 2]->left(std::move(subtrees[i]));
+    }
+    for ( size_t position { first_cut - 1 }; position > 1; --position )
+    {
+        if ( !top[position] ) continue;
+        if ( position % 2 ) top[position / 2]->right(std::move(top[position]));
+        else                top[position / 2]->left(std::move(top[position]));
+    }
+    return std::move(top[1]);
+}
+
+}  // namespace tree
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "augmented.hpp"
+
+
+namespace tree
+{
+
+// Closed interval [lo, hi] with a value. Ordered by lo, then hi; the value doesn't take part.
+template<typename K, typename V>
+struct Interval
+{
+    K lo;
+    K hi;
+    V value {};
+
+    auto operator<=>(const Interval& other) const
+    {
+        if ( auto order { lo <=> other.lo }; order != 0 ) return order;
+        return hi <=> other.hi;
+    }
+    bool operator==(const Interval& other) const { return lo == other.lo && hi == other.hi; }
+};
+
+// Monoid of the largest endpoint of intervals.
+template<typename K, typename V>
+struct MaxEnd
+{
+    using summary_type = std::optional<K>;
+    static summary_type identity() { return std::nullopt; }
+    static summary_type lift(const Interval<K, V>& interval) { return interval.hi; }
+    static summary_type combine(const summary_type& left, const summary_type& right)
+    {
+        if ( !left ) return right;
+        if ( !right ) return left;
+        return std::max(*left, *right);
+    }
+};
+
+/*
+    Set of closed intervals answering overlap queries.
+
+    An AVL tree ordered by lower endpoint, where every node keeps the largest
+    upper endpoint of its subtree (augmentation policy of AVL, updated by
+    rotations and balancing). A query skips every subtree whose largest
+    endpoint is left of the query, and every right subtree of a node starting
+    right of it, so reporting k intervals costs O(log n + k).
+
+        tree::IntervalTree<int, std::string> schedule;
+        schedule.insert(9, 11, "meeting");
+        schedule.overlapping(10, 12, [](const auto& interval){ ... });
+*/
+template<typename K, typename V>
+class IntervalTree
+{
+public:
+
+    using interval_type = Interval<K, V>;
+
+private:
+
+    using Monoid = MaxEnd<K, V>;
+    using value_type = Augmented<interval_type, Monoid>;
+
+    AVL<value_type, NoStats, Summarize<Monoid>> tree_;
+    size_t size_ { 0 };
+
+    template<typename F>
+    static bool overlapping_(const std::unique_ptr<Node<value_type>>& node, const K& a, const K& b, F& fnc)
+    {
+        if ( !node || *node->data.summary < a ) return true;   // Everything here ends before a.
+        if ( !overlapping_(node->left(), a, b, fnc) ) return false;
+        const interval_type& interval { node->data.value };
+        if ( b < interval.lo ) return true;                     // This and everything right starts after b.
+        if ( !(interval.hi < a) && !detail::visit(fnc, interval) ) return false;
+        return overlapping_(node->right(), a, b, fnc);
+    }
+
+public:
+
+    /*
+        Constructors
+    */
+    IntervalTree() {}
+
+    IntervalTree(const std::vector<interval_type>& intervals)
+    {
+        for ( const auto& interval : intervals ) insert(interval);
+    }
+
+    /*
+        Public member functions
+    */
+
+    void insert(const interval_type& interval)
+    {
+        tree_.add(value_type(interval));
+        ++size_;
+    }
+    void insert(K lo, K hi, V value = {}) { insert(interval_type{lo, hi, std::move(value)}); }
+
+    // Remove one interval [lo, hi]. Returns false if there is none.
+    bool erase(K lo, K hi)
+    {
+        bool removed { tree_.remove(value_type(interval_type{lo, hi})) };
+        size_ -= removed;
+        return removed;
+    }
+
+    /*
+        Call fnc for every interval overlapping [a, b], ordered by lower endpoint.
+        If fnc returns tree::Visit, the query ends after the first Visit::stop.
+    */
+    template<typename F>
+    void overlapping(const K& a, const K& b, F fnc) const { overlapping_(tree_.root(), a, b, fnc); }
+
+    std::vector<interval_type> overlapping(const K& a, const K& b) const
+    {
+        std::vector<interval_type> result;
+        overlapping(a, b, [&](const interval_type& interval){ result.push_back(interval); });
+        return result;
+    }
+
+    // Intervals containing point.
+    template<typename F>
+    void stabbing(const K& point, F fnc) const { overlapping(point, point, fnc); }
+
+    std::vector<interval_type> stabbing(const K& point) const { return overlapping(point, point); }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Largest upper endpoint of all intervals.
+    std::optional<K> max_end() const { return tree_.root() ? tree_.root()->data.summary : std::nullopt; }
+
+    const std::unique_ptr<Node<value_type>>& root() const { return tree_.root(); }
+
+};
+
+}  // namespace tree
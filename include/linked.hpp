@@ -8,7 +8,9 @@
 #include <memory>
 #include <concepts>
 #include <type_traits>
-#include <stack>
+#include <vector>
+
+#include "generator.hpp"
 
 
 namespace tree
@@ -25,6 +27,68 @@ enum class Degree : int
 template<typename T>
 class Node;
 
+/*
+    Non-owning, movable pointer to a node of a tree.
+
+    Nodes keep a link to their parent, so a cursor can move up, down and to the
+    in-order neighbours without allocating. Moving to a missing node leaves the
+    cursor empty.
+*/
+template<typename T>
+class Cursor
+{
+private:
+
+    Node<T>* node_ { nullptr };
+
+public:
+
+    Cursor() {}
+    explicit Cursor(Node<T>* node) : node_{node} {}
+
+    // Leftmost and rightmost node of a subtree.
+    static Node<T>* first(Node<T>* node)
+    {
+        if ( node ) while ( node->left() ) node = node->left().get();
+        return node;
+    }
+    static Node<T>* last(Node<T>* node)
+    {
+        if ( node ) while ( node->right() ) node = node->right().get();
+        return node;
+    }
+
+    // In-order successor of a node, nullptr for the last node.
+    static Node<T>* successor(Node<T>* node)
+    {
+        if ( node->right() ) return first(node->right().get());
+        while ( node->parent() && node == node->parent()->right().get() ) node = node->parent();
+        return node->parent();
+    }
+
+    // In-order predecessor of a node, nullptr for the first node.
+    static Node<T>* predecessor(Node<T>* node)
+    {
+        if ( node->left() ) return last(node->left().get());
+        while ( node->parent() && node == node->parent()->left().get() ) node = node->parent();
+        return node->parent();
+    }
+
+    Cursor& parent() { node_ = node_->parent();      return *this; }
+    Cursor& left()   { node_ = node_->left().get();  return *this; }
+    Cursor& right()  { node_ = node_->right().get(); return *this; }
+    Cursor& next()   { node_ = successor(node_);     return *this; }
+    Cursor& prev()   { node_ = predecessor(node_);   return *this; }
+
+    Node<T>* get() const { return node_; }
+    T& operator*() const { return node_->data; }
+    T* operator->() const { return &node_->data; }
+    explicit operator bool() const { return node_ != nullptr; }
+
+    bool operator==(const Cursor& other) const { return node_ == other.node_; }
+
+};
+
 template<typename T>
 class InOrderIterator
 {
@@ -38,18 +102,13 @@ private:
         dereference operator operator*()    -> Gets value
         and equality operators operator==() -> What are these supposed to do?
                            and operator!=()
+
+        Iterator follows parent links, so it doesn't allocate and copying it is
+        cheap. It never climbs above the root of the subtree it was created for.
     */
 
-    std::stack<Node<T>*> stack_;
-
-    void push_left_(Node<T>* node)
-    {
-        while(node)
-        {
-            stack_.push(node);
-            node = node->left().get();
-        }
-    }
+    Node<T>* node_ { nullptr };
+    Node<T>* root_ { nullptr };
 
 public:
 
@@ -60,20 +119,29 @@ public:
     using reference = T&;
 
     InOrderIterator(Node<T>* root)
-    {
-        push_left_(root);
-    }
+        : node_{Cursor<T>::first(root)}, root_{root} {}
+
+    // Iterator at node of the tree with given root.
+    InOrderIterator(Node<T>* node, Node<T>* root)
+        : node_{node}, root_{root} {}
 
     value_type operator*() const
     {
-        return stack_.top()->data;
+        return node_->data;
     }
 
+    // Node the iterator points to, nullptr for end.
+    Node<T>* node() const { return node_; }
+
     InOrderIterator<T>& operator++()    // Pre-increment
     {
-        auto node { stack_.top() };
-        stack_.pop();
-        push_left_(node->right().get());
+        if ( node_->right() )
+        {
+            node_ = Cursor<T>::first(node_->right().get());
+            return *this;
+        }
+        while ( node_ != root_ && node_ == node_->parent()->right().get() ) node_ = node_->parent();
+        node_ = ( node_ == root_ ) ? nullptr : node_->parent();
         return *this;
     }
     InOrderIterator<T> operator++(int)  // Post-increment
@@ -90,8 +158,7 @@ public:
 
     bool operator==(const InOrderIterator& other) const
     {
-        return stack_.empty() && other.stack_.empty();  // TO DO: Check the logic behind this.
-
+        return node_ == other.node_;
     }
 
 };
@@ -103,8 +170,16 @@ private:
 
     std::unique_ptr<Node<T>> right_ { nullptr };
     std::unique_ptr<Node<T>> left_  { nullptr };
+    Node<T>* parent_ { nullptr };   // Maintained by the child setters and release functions.
     size_t height_ { 1 };
 
+    // Make this node parent of its children.
+    void adopt_()
+    {
+        if ( right_ ) right_->parent_ = this;
+        if ( left_ )  left_->parent_  = this;
+    }
+
 public:
 
     T data;
@@ -130,11 +205,48 @@ public:
     Node(const Node& other) = delete;
     Node& operator=(const Node& other) = delete;
 
+    /*
+        Destroying children through nested unique_ptr destructors recurses once
+        per level, which overflows the stack for very deep trees. Instead, the
+        subtrees are taken apart iteratively, see release_subtree.
+    */
+    ~Node()
+    {
+        release_subtree(std::move(left_));
+        release_subtree(std::move(right_));
+    }
+
+    /*
+        Free a whole subtree in O(1) stack space. While the current node has a
+        left child it is rotated right, which moves the left child up. Once
+        there is no left child, the node is freed and its right child becomes
+        current. Every freed node has no children left, so its destructor
+        doesn't recurse.
+    */
+    static void release_subtree(std::unique_ptr<Node<T>> it)
+    {
+        while ( it )
+        {
+            if ( it->left_ )
+            {
+                auto left { std::move(it->left_) };
+                it->left_ = std::move(left->right_);
+                left->right_ = std::move(it);
+                it = std::move(left);
+            }
+            else
+            {
+                it = std::move(it->right_);
+            }
+        }
+    }
+
     Node(Node&& other)
     {
         right_ = std::move(other.right_);
         left_ = std::move(other.left_);
         data = std::move(other.data);
+        adopt_();
     }
 
     Node& operator= (Node&& other)
@@ -142,6 +254,7 @@ public:
         right_ = std::move(other.right_);
         left_ = std::move(other.left_);
         data = std::move(other.data);
+        adopt_();
         return *this;
     }
 
@@ -152,16 +265,19 @@ public:
     std::unique_ptr<Node<T>>& right(std::unique_ptr<Node<T>>&& child)
     {
         right_ = std::move(child);
+        if ( right_ ) right_->parent_ = this;
         return right_;
     }
     std::unique_ptr<Node<T>>& right(Node<T>&& child)
     {
         right_ = std::make_unique<Node<T>>(std::forward<Node<T>&&>(child));
+        right_->parent_ = this;
         return right_;
     }
     std::unique_ptr<Node<T>>& right(T new_data)
     {
         right_ = std::make_unique<Node<T>>(new_data);
+        right_->parent_ = this;
         return right_;
     }
     template<typename... Args>
@@ -169,24 +285,33 @@ public:
     std::unique_ptr<Node<T>>& right(Args&&... args)
     {
         right_ = std::make_unique<Node<T>>(args...);
+        right_->parent_ = this;
         return right_;
     }
     std::unique_ptr<Node<T>>& right() { return right_; }
-    std::unique_ptr<Node<T>> release_right() { return std::move(right_); }
+    const std::unique_ptr<Node<T>>& right() const { return right_; }
+    std::unique_ptr<Node<T>> release_right()
+    {
+        if ( right_ ) right_->parent_ = nullptr;
+        return std::move(right_);
+    }
 
     std::unique_ptr<Node<T>>& left(std::unique_ptr<Node<T>>&& child)
     {
         left_ = std::move(child);
+        if ( left_ ) left_->parent_ = this;
         return left_;
     }
     std::unique_ptr<Node<T>>& left(Node<T>&& child)
     {
         left_ = std::make_unique<Node<T>>(std::forward<Node<T>&&>(child));
+        left_->parent_ = this;
         return left_;
     }
     std::unique_ptr<Node<T>>& left(T new_data)
     {
         left_ = std::make_unique<Node<T>>(new_data);
+        left_->parent_ = this;
         return left_;
     }
     template<typename... Args>
@@ -197,10 +322,33 @@ public:
     std::unique_ptr<Node<T>>& left(Args&&... args)
     {
         left_ = std::make_unique<Node<T>>(args...);
+        left_->parent_ = this;
         return left_;
     }
     std::unique_ptr<Node<T>>& left() { return left_; }
-    std::unique_ptr<Node<T>> release_left() { return std::move(left_); }
+    const std::unique_ptr<Node<T>>& left() const { return left_; }
+    std::unique_ptr<Node<T>> release_left()
+    {
+        if ( left_ ) left_->parent_ = nullptr;
+        return std::move(left_);
+    }
+
+    Node<T>* parent() const { return parent_; }
+
+    /*
+        Put node in place of the node owned by slot, under the same parent, and
+        return the replaced node. For tree code that rewires an owning pointer
+        directly (rotations, removals).
+    */
+    static std::unique_ptr<Node<T>> replace(std::unique_ptr<Node<T>>& slot, std::unique_ptr<Node<T>> node)
+    {
+        Node<T>* parent { slot ? slot->parent_ : nullptr };
+        std::unique_ptr<Node<T>> old { std::move(slot) };
+        if ( old ) old->parent_ = nullptr;
+        slot = std::move(node);
+        if ( slot ) slot->parent_ = parent;
+        return old;
+    }
 
     // Operators
     auto operator<=>(const Node<T>& other) const
@@ -349,33 +497,129 @@ void print(const std::unique_ptr<Node<T>>& node, int depth = 0)
 
 // Traversals
 
+/*
+    A traversal callback either returns nothing, and the whole tree is
+    visited, or returns Visit, and the traversal ends after the first
+    Visit::stop.
+*/
+enum class Visit
+{
+    proceed,
+    stop,
+};
+
+namespace detail
+{
+
+// Call the traversal callback, false means stop.
+template<typename F, typename T>
+bool visit(F& fnc, T& data)
+{
+    if constexpr ( std::is_same_v<std::invoke_result_t<F&, T&>, Visit> )
+        return fnc(data) == Visit::proceed;
+    else
+    {
+        fnc(data);
+        return true;
+    }
+}
+
 template<typename T, typename F>
-void in_order(const std::unique_ptr<Node<T>>& root, F fnc)
+bool visit_in_order(const std::unique_ptr<Node<T>>& root, F& fnc)
 {
-    if ( root == nullptr ) return;
-    in_order(root->left_, fnc);
-    fnc(root->data);
-    in_order(root->right_, fnc);
+    if ( root == nullptr ) return true;
+    return visit_in_order(root->left(), fnc) && visit(fnc, root->data) && visit_in_order(root->right(), fnc);
 }
 
 template<typename T, typename F>
-void pre_order(const std::unique_ptr<Node<T>>& root, F fnc)
+bool visit_pre_order(const std::unique_ptr<Node<T>>& root, F& fnc)
 {
-    if ( root == nullptr ) return;
-    fnc(root->data);
-    pre_order(root->left_, fnc);
-    pre_order(root->right_, fnc);
+    if ( root == nullptr ) return true;
+    return visit(fnc, root->data) && visit_pre_order(root->left(), fnc) && visit_pre_order(root->right(), fnc);
 }
 
 template<typename T, typename F>
-void post_order(const std::unique_ptr<Node<T>>& root, F fnc)
+bool visit_post_order(const std::unique_ptr<Node<T>>& root, F& fnc)
 {
-    if ( root == nullptr ) return;
-    post_order(root->left_, fnc);
-    post_order(root->right_, fnc);
-    fnc(root->data);
+    if ( root == nullptr ) return true;
+    return visit_post_order(root->left(), fnc) && visit_post_order(root->right(), fnc) && visit(fnc, root->data);
 }
 
+/*
+    Coroutines behind the lazy traversals. They take the root by pointer,
+    because the body runs only once the generator is iterated.
+*/
+
+template<typename T>
+Generator<T> generate_in_order(Node<T>* root)
+{
+    for ( InOrderIterator<T> it { root }, end { nullptr }; it != end; ++it )
+        co_yield it.node()->data;
+}
+
+template<typename T>
+Generator<T> generate_pre_order(Node<T>* root)
+{
+    std::vector<Node<T>*> stack;
+    if ( root ) stack.push_back(root);
+    while ( !stack.empty() )
+    {
+        Node<T>* it { stack.back() };
+        stack.pop_back();
+        if ( it->right() ) stack.push_back(it->right().get());
+        if ( it->left() )  stack.push_back(it->left().get());
+        co_yield it->data;
+    }
+}
+
+template<typename T>
+Generator<T> generate_post_order(Node<T>* root)
+{
+    // Descend to the first node in post-order, then climb; a node is visited
+    // once its right subtree is done.
+    auto first = [](Node<T>* it)
+    {
+        while ( it->left() || it->right() ) it = it->left() ? it->left().get() : it->right().get();
+        return it;
+    };
+    if ( root == nullptr ) co_return;
+    Node<T>* it { first(root) };
+    while ( true )
+    {
+        co_yield it->data;
+        if ( it == root ) co_return;
+        Node<T>* parent { it->parent() };
+        if ( it == parent->left().get() && parent->right() ) it = first(parent->right().get());
+        else                                                 it = parent;
+    }
+}
+
+template<typename T>
+Generator<T> generate_level_order(Node<T>* root)
+{
+    std::queue<Node<T>*> q;
+    if ( root ) q.push(root);
+    while ( !q.empty() )
+    {
+        Node<T>* it { q.front() };
+        q.pop();
+        if ( it->left() )  q.push(it->left().get());
+        if ( it->right() ) q.push(it->right().get());
+        co_yield it->data;
+    }
+}
+
+}  // namespace detail
+
+template<typename T, typename F>
+void in_order(const std::unique_ptr<Node<T>>& root, F fnc) { detail::visit_in_order(root, fnc); }
+
+template<typename T, typename F>
+void pre_order(const std::unique_ptr<Node<T>>& root, F fnc) { detail::visit_pre_order(root, fnc); }
+
+template<typename T, typename F>
+void post_order(const std::unique_ptr<Node<T>>& root, F fnc) { detail::visit_post_order(root, fnc); }
+
 template<typename T, typename F>
 void level_order(const std::unique_ptr<Node<T>>& root, F fnc)
 {
@@ -386,12 +630,31 @@ void level_order(const std::unique_ptr<Node<T>>& root, F fnc)
     {
         const Node<T>* it { q.front() };
         q.pop();
-        fnc(it->data);
+        if ( !detail::visit(fnc, it->data) ) return;
         if ( it->left_ != nullptr )  q.push(it->left_.get());
         if ( it->right_ != nullptr ) q.push(it->right_.get());
     }
 }
 
+/*
+    Lazy traversals. Nodes are visited as the generator is iterated, so the
+    consumer can stop early.
+
+        auto big = tree::in_order(root) | std::views::filter([](int key){ return key > 100; });
+*/
+
+template<typename T>
+Generator<T> in_order(const std::unique_ptr<Node<T>>& root) { return detail::generate_in_order(root.get()); }
+
+template<typename T>
+Generator<T> pre_order(const std::unique_ptr<Node<T>>& root) { return detail::generate_pre_order(root.get()); }
+
+template<typename T>
+Generator<T> post_order(const std::unique_ptr<Node<T>>& root) { return detail::generate_post_order(root.get()); }
+
+template<typename T>
+Generator<T> level_order(const std::unique_ptr<Node<T>>& root) { return detail::generate_level_order(root.get()); }
+
 // Tree Type
 
 /*
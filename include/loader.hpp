@@ -0,0 +1,370 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "linked.hpp"
+#include "succinct.hpp"
+
+
+namespace tree
+{
+
+/*
+    Bounded lock-free queue for one producer thread and one consumer thread.
+
+    Producer and consumer indices live on their own cache lines; each side
+    writes only its own index and reads the other one with acquire ordering.
+*/
+template<typename T, size_t Capacity>
+requires (Capacity > 0 && (Capacity & (Capacity - 1)) == 0)
+class SpscQueue
+{
+private:
+
+    std::array<T, Capacity> slots_ {};
+    alignas(64) std::atomic<size_t> head_ { 0 };   // Next slot to pop, written by the consumer.
+    alignas(64) std::atomic<size_t> tail_ { 0 };   // Next slot to push, written by the producer.
+
+public:
+
+    bool try_push(T item)
+    {
+        size_t tail { tail_.load(std::memory_order_relaxed) };
+        if ( tail - head_.load(std::memory_order_acquire) == Capacity ) return false;
+        slots_[tail % Capacity] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& item)
+    {
+        size_t head { head_.load(std::memory_order_relaxed) };
+        if ( head == tail_.load(std::memory_order_acquire) ) return false;
+        item = std::move(slots_[head % Capacity]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+};
+
+
+namespace detail
+{
+
+// Spin until item is pushed, false if stop was requested first.
+template<typename Queue, typename T>
+bool push(Queue& queue, T item, const std::atomic<bool>& stop)
+{
+    while ( !queue.try_push(item) )
+    {
+        if ( stop.load(std::memory_order_relaxed) ) return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+template<typename Queue, typename T>
+bool pop(Queue& queue, T& item, const std::atomic<bool>& stop)
+{
+    while ( !queue.try_pop(item) )
+    {
+        if ( stop.load(std::memory_order_relaxed) ) return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+// Parse a token of a serialized tree, "#" or a number. False for null, throws std::runtime_error if invalid.
+template<typename T>
+bool parse_token(const char* first, const char* last, T& value)
+{
+    if ( last - first == 1 && *first == '#' ) return false;
+    auto [end, error] { std::from_chars(first, last, value) };
+    if ( error != std::errc() || end != last ) throw std::runtime_error("load_tree: invalid token");
+    return true;
+}
+
+/*
+    Builds a tree from the tokens of its pre-order serialization, with an
+    explicit stack of child slots still to fill instead of recursion.
+*/
+template<typename T>
+class PreorderBuilder
+{
+private:
+
+    struct Slot
+    {
+        Node<T>* parent;
+        bool left;
+    };
+
+    std::unique_ptr<Node<T>> root_;
+    std::vector<Slot> slots_;     // The top one is the next in pre-order.
+    bool started_ { false };
+
+public:
+
+    // Take the next token, value is ignored for null. False once the tree is complete.
+    bool add(bool null, T value)
+    {
+        Node<T>* node { nullptr };
+        if ( !started_ )
+        {
+            started_ = true;
+            if ( !null ) node = (root_ = std::make_unique<Node<T>>(value)).get();
+        }
+        else
+        {
+            Slot slot { slots_.back() };
+            slots_.pop_back();
+            if ( !null )
+            {
+                auto child { std::make_unique<Node<T>>(value) };
+                node = (slot.left ? slot.parent->left(std::move(child)) : slot.parent->right(std::move(child))).get();
+            }
+        }
+        if ( node )
+        {
+            slots_.push_back({ node, false });
+            slots_.push_back({ node, true });
+        }
+        return !slots_.empty();
+    }
+
+    bool complete() const { return started_ && slots_.empty(); }
+
+    std::unique_ptr<Node<T>> release() { return std::move(root_); }
+
+};
+
+}  // namespace detail
+
+
+// Sizes of the stages of load_tree.
+struct LoadOptions
+{
+    size_t buffer_size { 1 << 20 };   // Bytes read at once.
+    size_t batch_size  { 4096 };      // Tokens passed from parser to builder at once.
+};
+
+/*
+    Load a tree from a file written by serialize, or by SuccinctTree::save.
+
+    Text files go through three stages running at once:
+        reader   thread, reads the file into large page-aligned buffers,
+        parser   thread, splits buffers into tokens with std::from_chars,
+        builder  calling thread, links nodes in pre-order with an explicit stack.
+    Stages pass buffers and batches of tokens through SpscQueues and hand
+    them back empty through a second queue, so memory stays bounded by a few
+    buffers and batches. Tokens split by the end of a buffer are carried
+    over to the next one.
+
+    Succinct files, recognized by their magic, are loaded and converted.
+    Throws std::runtime_error for a file that can't be read or parsed.
+
+        auto root { tree::load_tree<int>("data/tree_1.tr") };
+*/
+template<typename T>
+requires std::is_arithmetic_v<T>
+std::unique_ptr<Node<T>> load_tree(const std::filesystem::path& path, LoadOptions options = {})
+{
+    std::ifstream in { path, std::ios::binary };
+    if ( !in ) throw std::runtime_error("load_tree: cannot open " + path.string());
+    char magic[4] {};
+    in.read(magic, 4);
+    if ( in.gcount() == 4 && std::memcmp(magic, "SBT1", 4) == 0 )
+    {
+        in.seekg(0);
+        return SuccinctTree<T>::load(in).to_nodes();
+    }
+    in.clear();
+    in.seekg(0);
+
+    constexpr size_t QUEUE { 4 };
+    constexpr size_t MAX_TOKEN { 64 };
+    const size_t buffer_size { std::max<size_t>(options.buffer_size, MAX_TOKEN) };
+    const size_t batch_size { std::max<size_t>(options.batch_size, 1) };
+
+    struct Aligned_Delete
+    {
+        void operator()(char* ptr) const { ::operator delete[](ptr, std::align_val_t{4096}); }
+    };
+    struct Buffer
+    {
+        std::unique_ptr<char[], Aligned_Delete> data;
+        size_t size { 0 };
+        bool last { false };
+    };
+    struct Token
+    {
+        T value {};
+        bool null { true };
+    };
+    struct Batch
+    {
+        std::vector<Token> tokens;
+        bool last { false };
+    };
+
+    // QUEUE buffers and batches circulate; a queue of each kind holds all of them, so pushes back never wait.
+    std::vector<Buffer> buffers(QUEUE);
+    std::vector<Batch> batches(QUEUE);
+    SpscQueue<Buffer*, QUEUE> full_buffers, free_buffers;
+    SpscQueue<Batch*, QUEUE> full_batches, free_batches;
+    for ( Buffer& buffer : buffers )
+    {
+        buffer.data.reset(static_cast<char*>(::operator new[](buffer_size, std::align_val_t{4096})));
+        free_buffers.try_push(&buffer);
+    }
+    for ( Batch& batch : batches )
+    {
+        batch.tokens.reserve(batch_size);
+        free_batches.try_push(&batch);
+    }
+
+    std::atomic<bool> stop { false };
+    std::exception_ptr reader_error, parser_error;
+
+    auto read { [&]{
+        try
+        {
+            bool last { false };
+            while ( !last )
+            {
+                Buffer* buffer;
+                if ( !detail::pop(free_buffers, buffer, stop) ) return;
+                in.read(buffer->data.get(), static_cast<std::streamsize>(buffer_size));
+                buffer->size = static_cast<size_t>(in.gcount());
+                if ( in.bad() ) throw std::runtime_error("load_tree: cannot read " + path.string());
+                buffer->last = last = buffer->size < buffer_size;
+                if ( !detail::push(full_buffers, buffer, stop) ) return;
+            }
+        }
+        catch ( ... )
+        {
+            reader_error = std::current_exception();
+            stop = true;
+        }
+    } };
+
+    auto parse { [&]{
+        try
+        {
+            Batch* batch;
+            if ( !detail::pop(free_batches, batch, stop) ) return;
+            batch->tokens.clear();
+            auto emit { [&](const char* first, const char* last) -> bool {
+                Token token;
+                token.null = !detail::parse_token(first, last, token.value);
+                batch->tokens.push_back(token);
+                if ( batch->tokens.size() < batch_size ) return true;
+                batch->last = false;
+                if ( !detail::push(full_batches, batch, stop) || !detail::pop(free_batches, batch, stop) ) return false;
+                batch->tokens.clear();
+                return true;
+            } };
+
+            char carry[MAX_TOKEN];   // Start of a token cut by the end of the previous buffer.
+            size_t carried { 0 };
+            bool last { false };
+            while ( !last )
+            {
+                Buffer* buffer;
+                if ( !detail::pop(full_buffers, buffer, stop) ) return;
+                last = buffer->last;
+                const char* it { buffer->data.get() };
+                const char* end { it + buffer->size };
+                auto space { [](char c){ return c == ' ' || c == '\n' || c == '\r' || c == '\t'; } };
+                if ( carried )
+                {
+                    const char* rest { it };
+                    while ( rest != end && !space(*rest) ) ++rest;
+                    if ( carried + (rest - it) > MAX_TOKEN ) throw std::runtime_error("load_tree: token too long in " + path.string());
+                    std::memcpy(carry + carried, it, rest - it);
+                    carried += rest - it;
+                    it = rest;
+                    if ( it != end || last )
+                    {
+                        if ( !emit(carry, carry + carried) ) return;
+                        carried = 0;
+                    }
+                }
+                while ( it != end )
+                {
+                    while ( it != end && space(*it) ) ++it;
+                    const char* first { it };
+                    while ( it != end && !space(*it) ) ++it;
+                    if ( first == it ) break;
+                    if ( it == end && !last )
+                    {
+                        if ( static_cast<size_t>(it - first) > MAX_TOKEN ) throw std::runtime_error("load_tree: token too long in " + path.string());
+                        std::memcpy(carry, first, it - first);
+                        carried = it - first;
+                        break;
+                    }
+                    if ( !emit(first, it) ) return;
+                }
+                if ( !detail::push(free_buffers, buffer, stop) ) return;
+            }
+            batch->last = true;
+            detail::push(full_batches, batch, stop);
+        }
+        catch ( ... )
+        {
+            parser_error = std::current_exception();
+            stop = true;
+        }
+    } };
+
+    std::unique_ptr<Node<T>> root;
+    {
+        // Stop and join both threads on any way out of the builder.
+        std::jthread reader { read };
+        std::jthread parser { parse };
+        struct Stop_Guard
+        {
+            std::atomic<bool>& stop;
+            ~Stop_Guard() { stop = true; }
+        } guard { stop };
+
+        detail::PreorderBuilder<T> builder;
+        bool done { false };
+        while ( !done )
+        {
+            Batch* batch;
+            if ( !detail::pop(full_batches, batch, stop) ) break;
+            for ( const Token& token : batch->tokens )
+            {
+                // Tokens after a complete tree are ignored, as by deserialize.
+                if ( !builder.add(token.null, token.value) ) { done = true; break; }
+            }
+            bool last { batch->last };
+            if ( !done && !last ) detail::push(free_batches, batch, stop);
+            if ( last ) break;
+        }
+        stop = true;
+        reader.join();
+        parser.join();
+        if ( reader_error ) std::rethrow_exception(reader_error);
+        if ( parser_error ) std::rethrow_exception(parser_error);
+        if ( !done ) throw std::runtime_error("load_tree: " + path.string() + " ends inside the tree");
+        root = builder.release();
+    }
+    return root;
+}
+
+}  // namespace tree
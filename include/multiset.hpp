@@ -0,0 +1,203 @@
+#pragma once
+
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "avl.hpp"
+
+
+namespace tree
+{
+
+/*
+    AVL tree with one node per distinct key.
+
+    BST and AVL give every duplicate its own node. Multiset keeps the first
+    record of each key inline in the node with a count. Records that compare
+    equal but aren't the same according to Same (e.g. My_Data with equal key
+    and different name) go to a small bucket of the node, each with its own
+    count. Adding or removing a duplicate changes a count and leaves the tree
+    shape alone.
+
+        tree::Multiset<int> counters;
+        counters.add(7);
+        counters.add(7);
+        counters.count(7);   // 2
+
+    Iteration yields every record as many times as it was added.
+*/
+template<typename T, typename Same = std::equal_to<T>, typename Stats = NoStats>
+class Multiset
+{
+private:
+
+    // All records equal to one key.
+    struct Entry
+    {
+        T value;                                // First record, its key orders the entry.
+        size_t count { 1 };
+        std::vector<std::pair<T, size_t>> others;  // Equal but not the same records.
+
+        Entry() {}
+        Entry(T value_) : value{std::move(value_)} {}
+
+        auto operator<=>(const Entry& other) const { return value <=> other.value; }
+        bool operator==(const Entry& other) const { return value == other.value; }
+    };
+
+    AVL<Entry, Stats> tree_;
+    size_t size_ { 0 };
+    size_t distinct_ { 0 };
+    [[no_unique_address]] Same same_;
+
+public:
+
+    class Iterator
+    {
+    private:
+
+        InOrderIterator<Entry> node_;
+        size_t record_ { 0 };      // 0 is the inline record, i > 0 is others[i - 1].
+        size_t repeat_ { 0 };
+
+        const Entry& entry_() const { return node_.node()->data; }
+        size_t count_() const { return record_ == 0 ? entry_().count : entry_().others[record_ - 1].second; }
+
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        Iterator(InOrderIterator<Entry> node) : node_{node} {}
+
+        const T& operator*() const
+        {
+            return record_ == 0 ? entry_().value : entry_().others[record_ - 1].first;
+        }
+
+        Iterator& operator++()
+        {
+            if ( ++repeat_ < count_() ) return *this;
+            repeat_ = 0;
+            if ( ++record_ <= entry_().others.size() ) return *this;
+            record_ = 0;
+            ++node_;
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator temp { *this };
+            ++(*this);
+            return temp;
+        }
+
+        bool operator==(const Iterator& other) const
+        {
+            return node_ == other.node_ && record_ == other.record_ && repeat_ == other.repeat_;
+        }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+    };
+
+    /*
+        Constructors
+    */
+    Multiset() {}
+
+    Multiset(const std::vector<T>& data) { for ( const T& value : data ) add(value); }
+
+    /*
+        Public member functions
+    */
+
+    void add(const T& value)
+    {
+        ++size_;
+        auto cursor { tree_.find(Entry(value)) };
+        if ( !cursor )
+        {
+            tree_.add(Entry(value));
+            ++distinct_;
+            return;
+        }
+        Entry& entry { *cursor };
+        if ( same_(entry.value, value) )
+        {
+            ++entry.count;
+            return;
+        }
+        for ( auto& [other, count] : entry.others )
+        {
+            if ( same_(other, value) )
+            {
+                ++count;
+                return;
+            }
+        }
+        entry.others.emplace_back(value, 1);
+    }
+
+    // Remove one record same as value. Returns false if there is none.
+    bool remove(const T& value)
+    {
+        auto cursor { tree_.find(Entry(value)) };
+        if ( !cursor ) return false;
+        Entry& entry { *cursor };
+        if ( same_(entry.value, value) )
+        {
+            --size_;
+            if ( --entry.count > 0 ) return true;
+            if ( entry.others.empty() )
+            {
+                --distinct_;
+                return tree_.remove(Entry(value));
+            }
+            // Promote a bucket record, it has the same key.
+            entry.value = std::move(entry.others.back().first);
+            entry.count = entry.others.back().second;
+            entry.others.pop_back();
+            return true;
+        }
+        for ( auto it { entry.others.begin() }; it != entry.others.end(); ++it )
+        {
+            if ( !same_(it->first, value) ) continue;
+            --size_;
+            if ( --it->second == 0 ) entry.others.erase(it);
+            return true;
+        }
+        return false;
+    }
+
+    // Number of records equal to key.
+    size_t count(const T& key)
+    {
+        auto cursor { tree_.find(Entry(key)) };
+        if ( !cursor ) return 0;
+        size_t total { cursor->count };
+        for ( const auto& other : cursor->others ) total += other.second;
+        return total;
+    }
+
+    bool contains(const T& key) { return static_cast<bool>(tree_.find(Entry(key))); }
+
+    // Number of records.
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Number of distinct keys, i.e. of nodes.
+    size_t distinct() const { return distinct_; }
+
+    size_t height() const { return tree::height(tree_.root()); }
+
+    Counters stats() const { return tree_.stats(); }
+
+    Iterator begin() { return Iterator(tree_.begin()); }
+    Iterator end() { return Iterator(tree_.end()); }
+
+};
+
+}  // namespace tree
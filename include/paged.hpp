@@ -0,0 +1,479 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "linked.hpp"
+
+
+namespace tree
+{
+
+// Page traffic of a BufferPool.
+struct IoStats
+{
+    std::uint64_t hits      { 0 };   // Page requests served from memory.
+    std::uint64_t reads     { 0 };   // Pages read from the file, one per miss.
+    std::uint64_t writes    { 0 };   // Dirty pages written to the file.
+    std::uint64_t evictions { 0 };   // Pages dropped from memory to make room.
+
+    double hit_ratio() const
+    {
+        std::uint64_t requests { hits + reads };
+        return requests ? static_cast<double>(hits) / requests : 0.0;
+    }
+};
+
+/*
+    Cache of fixed-size pages of a file, limited to a memory budget.
+
+    Pages are replaced by the CLOCK algorithm: every page has a reference
+    bit set on access, and the clock hand sweeps the frames, clearing set
+    bits and evicting the first page whose bit is already clear. Dirty pages
+    are written when evicted or flushed.
+
+    Pages aren't pinned. A pointer returned by page() is valid until the
+    next call of page(), so callers copy out what they need.
+*/
+template<size_t PageSize>
+class BufferPool
+{
+private:
+
+    static constexpr std::uint64_t NONE { ~std::uint64_t{0} };
+
+    struct Frame
+    {
+        std::uint64_t page { NONE };
+        bool dirty { false };
+        bool referenced { false };
+    };
+
+    std::fstream& file_;
+    std::vector<std::byte> memory_;
+    std::vector<Frame> frames_;
+    std::unordered_map<std::uint64_t, size_t> where_;   // Page to its frame.
+    size_t hand_ { 0 };
+    IoStats stats_;
+
+    std::byte* data_(size_t frame) { return memory_.data() + frame * PageSize; }
+
+    void write_back_(size_t frame)
+    {
+        file_.seekp(static_cast<std::streamoff>(frames_[frame].page * PageSize));
+        file_.write(reinterpret_cast<const char*>(data_(frame)), PageSize);
+        if ( !file_ ) throw std::runtime_error("BufferPool: cannot write page");
+        frames_[frame].dirty = false;
+        ++stats_.writes;
+    }
+
+    // Frame to load a page into, evicting its page if needed.
+    size_t victim_()
+    {
+        while ( true )
+        {
+            Frame& frame { frames_[hand_] };
+            size_t current { hand_ };
+            hand_ = (hand_ + 1) % frames_.size();
+            if ( frame.page == NONE ) return current;
+            if ( frame.referenced ) { frame.referenced = false; continue; }
+            if ( frame.dirty ) write_back_(current);
+            where_.erase(frame.page);
+            frame.page = NONE;
+            ++stats_.evictions;
+            return current;
+        }
+    }
+
+public:
+
+    // Keep at most budget bytes of pages in memory, at least one page.
+    BufferPool(std::fstream& file, size_t budget)
+        : file_{file}, memory_(std::max<size_t>(1, budget / PageSize) * PageSize),
+          frames_(std::max<size_t>(1, budget / PageSize)) {}
+
+    BufferPool(const BufferPool& other) = delete;
+    BufferPool& operator=(const BufferPool& other) = delete;
+
+    // Contents of a page. Pages past the end of the file read as zeros.
+    std::byte* page(std::uint64_t page)
+    {
+        if ( auto found { where_.find(page) }; found != where_.end() )
+        {
+            ++stats_.hits;
+            frames_[found->second].referenced = true;
+            return data_(found->second);
+        }
+        size_t frame { victim_() };
+        std::byte* data { data_(frame) };
+        file_.seekg(static_cast<std::streamoff>(page * PageSize));
+        file_.read(reinterpret_cast<char*>(data), PageSize);
+        std::streamsize count { file_.gcount() };
+        if ( count < static_cast<std::streamsize>(PageSize) )
+        {
+            std::fill(data + count, data + PageSize, std::byte{0});
+            file_.clear();
+        }
+        ++stats_.reads;
+        frames_[frame] = Frame{ page, false, true };
+        where_[page] = frame;
+        return data;
+    }
+
+    // Mark a page in memory as changed.
+    void dirty(std::uint64_t page)
+    {
+        if ( auto found { where_.find(page) }; found != where_.end() ) frames_[found->second].dirty = true;
+    }
+
+    // Write all dirty pages.
+    void flush()
+    {
+        for ( size_t frame {0}; frame < frames_.size(); ++frame )
+            if ( frames_[frame].page != NONE && frames_[frame].dirty ) write_back_(frame);
+        file_.flush();
+    }
+
+    size_t capacity() const { return frames_.size(); }
+    const IoStats& stats() const { return stats_; }
+    void reset_stats() { stats_ = {}; }
+
+};
+
+/*
+    AVL tree whose nodes live in fixed-size pages of a file, for key sets
+    larger than memory.
+
+    Nodes are records of a page: key, ids of both children and height. Page
+    0 holds the header (root, number of keys, free records); a node id is
+    page * records per page + slot, 0 meaning no node. Pages are cached by a
+    BufferPool with a memory budget, and stats() tells how well it does.
+    Removed records are reused before new ones are appended.
+
+    Balancing is the same as in AVL, done on records copied out of the pool
+    and written back only when they change. Equal keys go left, as in BST.
+
+        tree::PagedAVL<std::int64_t> index { "index.pages", 64 << 20 };   // 64 MiB of pages in memory.
+        index.add(7);
+        index.range(0, 10, [](std::int64_t key){ ... });
+        double hits { index.stats().hit_ratio() };
+
+    The file is reopened by constructing PagedAVL with the same path. Keys
+    must be trivially copyable.
+*/
+template<typename K, size_t PageSize = 4096>
+requires std::is_trivially_copyable_v<K>
+class PagedAVL
+{
+private:
+
+    using Id = std::uint64_t;
+
+    struct Record
+    {
+        Id left { 0 };
+        Id right { 0 };
+        std::uint32_t height { 1 };
+        K key {};
+    };
+
+    struct Header
+    {
+        char magic[4] { 'T', 'R', 'P', '1' };
+        std::uint32_t key_size { sizeof(K) };
+        std::uint64_t page_size { PageSize };
+        Id root { 0 };
+        std::uint64_t size { 0 };
+        Id next { 0 };        // First record never used.
+        Id free { 0 };        // Free records, chained through left.
+    };
+
+    static constexpr Id RECORDS { PageSize / sizeof(Record) };   // Records per page.
+    static_assert(RECORDS > 0 && sizeof(Header) <= PageSize, "page too small");
+
+    std::fstream file_;
+    Header header_;
+    BufferPool<PageSize> pool_;
+
+    Record read_(Id id)
+    {
+        Record node;
+        std::memcpy(&node, pool_.page(id / RECORDS) + (id % RECORDS) * sizeof(Record), sizeof(Record));
+        return node;
+    }
+
+    void write_(Id id, const Record& node)
+    {
+        std::byte* slot { pool_.page(id / RECORDS) + (id % RECORDS) * sizeof(Record) };
+        Record old;
+        std::memcpy(&old, slot, sizeof(Record));
+        if ( old.left == node.left && old.right == node.right && old.height == node.height && old.key == node.key ) return;
+        std::memcpy(slot, &node, sizeof(Record));
+        pool_.dirty(id / RECORDS);
+    }
+
+    Id allocate_(const K& key)
+    {
+        Id id { header_.free };
+        if ( id ) header_.free = read_(id).left;
+        else      id = header_.next++;
+        Record node;
+        node.key = key;
+        write_(id, node);
+        return id;
+    }
+
+    void free_(Id id)
+    {
+        Record node;
+        node.left = header_.free;
+        write_(id, node);
+        header_.free = id;
+    }
+
+    std::uint32_t height_(Id id) { return id ? read_(id).height : 0; }
+
+    void update_(Record& node) { node.height = std::max(height_(node.left), height_(node.right)) + 1; }
+
+    Id rotate_left_(Id id, Record& node)
+    {
+        Id pivot_id { node.right };
+        Record pivot { read_(pivot_id) };
+        node.right = pivot.left;
+        update_(node);
+        write_(id, node);
+        pivot.left = id;
+        pivot.height = std::max(node.height, height_(pivot.right)) + 1;
+        write_(pivot_id, pivot);
+        return pivot_id;
+    }
+
+    Id rotate_right_(Id id, Record& node)
+    {
+        Id pivot_id { node.left };
+        Record pivot { read_(pivot_id) };
+        node.left = pivot.right;
+        update_(node);
+        write_(id, node);
+        pivot.right = id;
+        pivot.height = std::max(node.height, height_(pivot.left)) + 1;
+        write_(pivot_id, pivot);
+        return pivot_id;
+    }
+
+    // Update, rebalance and store node, return id of the root of its subtree.
+    Id balance_(Id id, Record node)
+    {
+        update_(node);
+        long long skew { static_cast<long long>(height_(node.right)) - height_(node.left) };
+        if ( skew > 1 )
+        {
+            Record right { read_(node.right) };
+            if ( height_(right.left) > height_(right.right) ) node.right = rotate_right_(node.right, right);
+            return rotate_left_(id, node);
+        }
+        if ( skew < -1 )
+        {
+            Record left { read_(node.left) };
+            if ( height_(left.right) > height_(left.left) ) node.left = rotate_left_(node.left, left);
+            return rotate_right_(id, node);
+        }
+        write_(id, node);
+        return id;
+    }
+
+    Id add_(Id id, const K& key)
+    {
+        if ( !id ) return allocate_(key);
+        Record node { read_(id) };
+        if ( key <= node.key ) node.left = add_(node.left, key);
+        else                   node.right = add_(node.right, key);
+        return balance_(id, node);
+    }
+
+    Id extract_min_(Id id, K& min)
+    {
+        Record node { read_(id) };
+        if ( !node.left )
+        {
+            min = node.key;
+            free_(id);
+            return node.right;
+        }
+        node.left = extract_min_(node.left, min);
+        return balance_(id, node);
+    }
+
+    Id remove_(Id id, const K& key, bool& removed)
+    {
+        if ( !id ) return 0;
+        Record node { read_(id) };
+        if ( key == node.key )
+        {
+            removed = true;
+            if ( !node.left || !node.right )
+            {
+                free_(id);
+                return node.left ? node.left : node.right;
+            }
+            node.right = extract_min_(node.right, node.key);
+        }
+        else if ( key < node.key ) node.left = remove_(node.left, key, removed);
+        else                       node.right = remove_(node.right, key, removed);
+        if ( !removed ) return id;
+        return balance_(id, node);
+    }
+
+    // Equal keys may sit on both sides after rotations, so both sides are checked for the bounds.
+    template<typename F>
+    bool range_(Id id, const K& lo, const K& hi, F& fnc)
+    {
+        if ( !id ) return true;
+        Record node { read_(id) };
+        if ( !(node.key < lo) && !range_(node.left, lo, hi, fnc) ) return false;
+        if ( !(node.key < lo) && !(hi < node.key) && !detail::visit(fnc, node.key) ) return false;
+        if ( !(hi < node.key) ) return range_(node.right, lo, hi, fnc);
+        return true;
+    }
+
+    template<typename F>
+    bool in_order_(Id id, F& fnc)
+    {
+        if ( !id ) return true;
+        Record node { read_(id) };
+        return in_order_(node.left, fnc) && detail::visit(fnc, node.key) && in_order_(node.right, fnc);
+    }
+
+    void write_header_()
+    {
+        std::vector<std::byte> page(PageSize);
+        std::memcpy(page.data(), &header_, sizeof(Header));
+        file_.seekp(0);
+        file_.write(reinterpret_cast<const char*>(page.data()), PageSize);
+        if ( !file_ ) throw std::runtime_error("PagedAVL: cannot write header");
+    }
+
+    void open_(const std::filesystem::path& path)
+    {
+        if ( !std::filesystem::exists(path) ) std::ofstream { path, std::ios::binary };
+        file_.open(path, std::ios::in | std::ios::out | std::ios::binary);
+        if ( !file_ ) throw std::runtime_error("PagedAVL: cannot open " + path.string());
+        Header stored;
+        if ( file_.read(reinterpret_cast<char*>(&stored), sizeof(Header)) )
+        {
+            if ( std::memcmp(stored.magic, header_.magic, 4) != 0 || stored.key_size != sizeof(K) || stored.page_size != PageSize )
+                throw std::runtime_error("PagedAVL: " + path.string() + " is not a tree with this key and page size");
+            header_ = stored;
+        }
+        else
+        {
+            file_.clear();
+            header_.next = RECORDS;   // First record of page 1.
+            write_header_();
+        }
+    }
+
+public:
+
+    /*
+        Constructors
+    */
+
+    // Open or create the tree in path, keeping up to memory bytes of pages cached.
+    PagedAVL(const std::filesystem::path& path, size_t memory = 1 << 20)
+        : pool_{file_, memory}
+    {
+        open_(path);
+    }
+
+    PagedAVL(const PagedAVL& other) = delete;
+    PagedAVL& operator=(const PagedAVL& other) = delete;
+
+    ~PagedAVL()
+    {
+        try { flush(); }
+        catch ( ... ) {}
+    }
+
+    /*
+        Public member functions
+    */
+
+    void add(const K& key)
+    {
+        header_.root = add_(header_.root, key);
+        ++header_.size;
+    }
+
+    std::optional<K> search(const K& key)
+    {
+        for ( Id id { header_.root }; id; )
+        {
+            Record node { read_(id) };
+            if ( key == node.key ) return node.key;
+            id = key < node.key ? node.left : node.right;
+        }
+        return std::nullopt;
+    }
+
+    bool contains(const K& key) { return search(key).has_value(); }
+
+    bool remove(const K& key)
+    {
+        bool removed { false };
+        header_.root = remove_(header_.root, key, removed);
+        header_.size -= removed;
+        return removed;
+    }
+
+    /*
+        Call fnc for keys of [lo, hi] in order. If fnc returns tree::Visit,
+        the traversal ends after the first Visit::stop.
+    */
+    template<typename F>
+    void range(const K& lo, const K& hi, F fnc) { range_(header_.root, lo, hi, fnc); }
+
+    std::vector<K> range(const K& lo, const K& hi)
+    {
+        std::vector<K> keys;
+        range(lo, hi, [&](const K& key){ keys.push_back(key); });
+        return keys;
+    }
+
+    // Call fnc for every key in order, like range.
+    template<typename F>
+    void in_order(F fnc) { in_order_(header_.root, fnc); }
+
+    size_t size() const { return header_.size; }
+    bool empty() const { return header_.size == 0; }
+    size_t height() { return height_(header_.root); }
+
+    // Write dirty pages and the header.
+    void flush()
+    {
+        pool_.flush();
+        write_header_();
+        file_.flush();
+    }
+
+    // Pages the pool keeps in memory.
+    size_t cached_pages() const { return pool_.capacity(); }
+
+    // Pages of the file, header included.
+    size_t pages() const { return (header_.next + RECORDS - 1) / RECORDS; }
+
+    const IoStats& stats() const { return pool_.stats(); }
+    void reset_stats() { pool_.reset_stats(); }
+
+};
+
+}  // namespace tree
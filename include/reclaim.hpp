@@ -0,0 +1,106 @@
+#pragma once
+
+#include <memory>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+
+namespace tree
+{
+
+/*
+    Background reclaimer.
+
+    Freeing a large tree takes time proportional to its size. retire hands the
+    ownership of a detached tree (or anything else held by a smart pointer) to
+    a background thread, which frees it, so the calling thread doesn't stall.
+*/
+class Reclaimer
+{
+private:
+
+    struct Garbage
+    {
+        virtual ~Garbage() = default;
+    };
+
+    template<typename P>
+    struct Holder : Garbage
+    {
+        P pointer;
+        explicit Holder(P&& pointer_) : pointer{std::move(pointer_)} {}
+    };
+
+    std::mutex mutex_;
+    std::condition_variable ready_;     // Signals new garbage, or stop.
+    std::condition_variable drained_;   // Signals empty queue.
+    std::deque<std::unique_ptr<Garbage>> queue_;
+    bool busy_ { false };
+    std::jthread worker_;
+
+    void work_(std::stop_token stop)
+    {
+        std::unique_lock lock { mutex_ };
+        while ( true )
+        {
+            ready_.wait(lock, [&]{ return !queue_.empty() || stop.stop_requested(); });
+            if ( queue_.empty() ) return;  // Stop requested and nothing left to free.
+            auto garbage { std::move(queue_.front()) };
+            queue_.pop_front();
+            busy_ = true;
+            lock.unlock();
+            garbage.reset();
+            lock.lock();
+            busy_ = false;
+            if ( queue_.empty() ) drained_.notify_all();
+        }
+    }
+
+public:
+
+    Reclaimer()
+        : worker_{[this](std::stop_token stop) { work_(stop); }} {}
+
+    ~Reclaimer()
+    {
+        {
+            std::lock_guard lock { mutex_ };
+            worker_.request_stop();
+        }
+        ready_.notify_all();
+    }
+
+    Reclaimer(const Reclaimer&) = delete;
+    Reclaimer& operator=(const Reclaimer&) = delete;
+
+    // Reclaimer shared by all trees.
+    static Reclaimer& instance()
+    {
+        static Reclaimer reclaimer;
+        return reclaimer;
+    }
+
+    template<typename P>
+    void retire(P pointer)
+    {
+        if ( !pointer ) return;
+        auto garbage { std::make_unique<Holder<P>>(std::move(pointer)) };
+        {
+            std::lock_guard lock { mutex_ };
+            queue_.push_back(std::move(garbage));
+        }
+        ready_.notify_one();
+    }
+
+    // Block until everything retired so far has been freed.
+    void drain()
+    {
+        std::unique_lock lock { mutex_ };
+        drained_.wait(lock, [&]{ return queue_.empty() && !busy_; });
+    }
+
+};
+
+}  // namespace tree
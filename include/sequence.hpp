@@ -0,0 +1,286 @@
+#pragma once
+
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "avl.hpp"
+
+
+namespace tree
+{
+
+// Element of a Sequence with the number of elements in its subtree.
+template<typename T>
+struct Sized
+{
+    T value;
+    size_t size { 1 };
+
+    Sized() {}
+    Sized(T value_) : value{std::move(value_)} {}
+};
+
+// Augmentation policy keeping subtree sizes.
+struct SizeOf
+{
+    static constexpr bool enabled { true };
+
+    template<typename T>
+    static size_t of(const std::unique_ptr<Node<Sized<T>>>& node) { return node ? node->data.size : 0; }
+
+    template<typename T>
+    static void update(Node<Sized<T>>& node) { node.data.size = of<T>(node.left()) + of<T>(node.right()) + 1; }
+};
+
+/*
+    Sequence with O(log n) insertion and removal at any position (implicit-key AVL, a rope).
+
+    Elements are ordered by position only. Every node keeps the size of its
+    subtree, and the position of a node is the size of everything left of it.
+    Balancing uses the same rotations as AVL, with the size as augmentation.
+    Two sequences are joined, and a sequence is split, in O(log n).
+
+        tree::Sequence<char> text { std::vector<char>({'a', 'c'}) };
+        text.insert_at(1, 'b');              // a b c
+        auto tail { text.split_at(1) };     // text: a, tail: b c
+*/
+template<typename T>
+class Sequence
+{
+private:
+
+    using Item = Sized<T>;
+    using Balance = Rebalance<Item, SizeOf>;
+    using Link = std::unique_ptr<Node<Item>>;
+
+    Link root_ { nullptr };
+    [[no_unique_address]] NoStats stats_;
+
+    static size_t size_(const Link& node) { return SizeOf::of<T>(node); }
+
+    static Link leaf_(T value) { return std::make_unique<Node<Item>>(Item(std::move(value))); }
+
+    void insert_(Link& node, size_t i, T& value)
+    {
+        if ( !node )
+        {
+            node = leaf_(std::move(value));
+            return;
+        }
+        size_t left { size_(node->left()) };
+        if ( i <= left )
+        {
+            if ( node->left() ) insert_(node->left(), i, value);
+            else                node->left(leaf_(std::move(value)));
+        }
+        else
+        {
+            if ( node->right() ) insert_(node->right(), i - left - 1, value);
+            else                 node->right(leaf_(std::move(value)));
+        }
+        Balance::balance(node, stats_);
+    }
+
+    // Detach the first node of a subtree.
+    Link extract_first_(Link& node)
+    {
+        Link first;
+        if ( node->left() ) first = extract_first_(node->left());
+        else                first = Node<Item>::replace(node, node->release_right());
+        Balance::balance(node, stats_);
+        return first;
+    }
+
+    T erase_(Link& node, size_t i)
+    {
+        size_t left { size_(node->left()) };
+        T result;
+        if      ( i < left ) result = erase_(node->left(), i);
+        else if ( i > left ) result = erase_(node->right(), i - left - 1);
+        else
+        {
+            result = std::move(node->data.value);
+            if      ( !node->left() )  Node<Item>::replace(node, node->release_right());
+            else if ( !node->right() ) Node<Item>::replace(node, node->release_left());
+            else node->data.value = std::move(extract_first_(node->right())->data.value);
+        }
+        Balance::balance(node, stats_);
+        return result;
+    }
+
+    /*
+        Join left, middle node and right into one balanced tree. Descends the
+        spine of the taller tree to a subtree of about the height of the
+        other one, hangs both under middle there, and rebalances on the way up.
+    */
+    Link join_(Link left, Link middle, Link right)
+    {
+        if ( height(left) > height(right) + 1 )
+        {
+            left->right(join_(left->release_right(), std::move(middle), std::move(right)));
+            Balance::balance(left, stats_);
+            return left;
+        }
+        if ( height(right) > height(left) + 1 )
+        {
+            right->left(join_(std::move(left), std::move(middle), right->release_left()));
+            Balance::balance(right, stats_);
+            return right;
+        }
+        middle->left(std::move(left));
+        middle->right(std::move(right));
+        Balance::update(middle);
+        return middle;
+    }
+
+    // Split a tree into its first i elements and the rest.
+    std::pair<Link, Link> split_(Link node, size_t i)
+    {
+        if ( !node ) return {};
+        Link left { node->release_left() };
+        Link right { node->release_right() };
+        size_t left_size { size_(left) };
+        if ( i <= left_size )
+        {
+            auto [first, rest] { split_(std::move(left), i) };
+            return { std::move(first), join_(std::move(rest), std::move(node), std::move(right)) };
+        }
+        auto [first, rest] { split_(std::move(right), i - left_size - 1) };
+        return { join_(std::move(left), std::move(node), std::move(first)), std::move(rest) };
+    }
+
+    // Perfectly balanced tree of a range.
+    template<typename It>
+    Link build_(It first, size_t count)
+    {
+        if ( count == 0 ) return nullptr;
+        size_t middle { count / 2 };
+        Link node { leaf_(*std::next(first, middle)) };
+        node->left(build_(first, middle));
+        node->right(build_(std::next(first, middle + 1), count - middle - 1));
+        Balance::update(node);
+        return node;
+    }
+
+    void check_(size_t i, size_t limit) const
+    {
+        if ( i >= limit ) throw std::out_of_range("Sequence: position out of range");
+    }
+
+public:
+
+    class Iterator
+    {
+    private:
+
+        InOrderIterator<Item> it_;
+
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        Iterator(InOrderIterator<Item> it) : it_{it} {}
+
+        T& operator*() const { return it_.node()->data.value; }
+        T* operator->() const { return &it_.node()->data.value; }
+
+        Iterator& operator++()
+        {
+            ++it_;
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator temp { *this };
+            ++it_;
+            return temp;
+        }
+
+        bool operator==(const Iterator& other) const { return it_ == other.it_; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+    };
+
+    /*
+        Constructors
+    */
+    Sequence() {}
+
+    Sequence(const std::vector<T>& data) { root_ = build_(data.begin(), data.size()); }
+
+    /*
+        Public member functions
+    */
+
+    size_t size() const { return size_(root_); }
+    bool empty() const { return !root_; }
+
+    // Element at position i. Throws std::out_of_range.
+    T& at(size_t i)
+    {
+        check_(i, size());
+        Node<Item>* it { root_.get() };
+        while ( true )
+        {
+            size_t left { size_(it->left()) };
+            if      ( i < left ) it = it->left().get();
+            else if ( i > left ) { i -= left + 1; it = it->right().get(); }
+            else return it->data.value;
+        }
+    }
+    T& operator[](size_t i) { return at(i); }
+
+    // Insert value so it ends up at position i, 0 <= i <= size(). Throws std::out_of_range.
+    void insert_at(size_t i, T value)
+    {
+        check_(i, size() + 1);
+        insert_(root_, i, value);
+    }
+
+    void push_back(T value) { insert_at(size(), std::move(value)); }
+    void push_front(T value) { insert_at(0, std::move(value)); }
+
+    // Remove and return the element at position i. Throws std::out_of_range.
+    T erase_at(size_t i)
+    {
+        check_(i, size());
+        return erase_(root_, i);
+    }
+
+    // Append all elements of other, leaving it empty.
+    void concat(Sequence&& other)
+    {
+        if ( !other.root_ ) return;
+        if ( !root_ )
+        {
+            root_ = std::move(other.root_);
+            return;
+        }
+        Link middle { extract_first_(other.root_) };
+        root_ = join_(std::move(root_), std::move(middle), std::move(other.root_));
+    }
+
+    // Keep the first i elements, return the rest. Throws std::out_of_range.
+    Sequence split_at(size_t i)
+    {
+        check_(i, size() + 1);
+        auto [first, rest] { split_(std::move(root_), i) };
+        root_ = std::move(first);
+        Sequence tail;
+        tail.root_ = std::move(rest);
+        return tail;
+    }
+
+    Iterator begin() { return Iterator(InOrderIterator<Item>(root_.get())); }
+    Iterator end() { return Iterator(InOrderIterator<Item>(nullptr)); }
+
+    const Link& root() const { return root_; }
+
+};
+
+}  // namespace tree
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
+
+#include "avl.hpp"
+
+
+namespace tree
+{
+
+/*
+    N independent AVL trees, each behind its own lock; a key lives in the
+    shard picked by its hash.
+
+    Point operations lock only their shard, so writers on different shards
+    run in parallel. Lookups take the lock shared. Ordered traversals lock
+    all shards shared (in shard order, so they can't deadlock with each
+    other) and merge the shards' in-order iterators.
+
+        tree::ShardedAVL<int, 16> index;
+        index.add(7);                        // From any thread.
+        index.range(0, 10, [](int key){ ... });
+*/
+template<typename T, size_t N = 16, typename Hash = std::hash<T>>
+requires (N > 0)
+class ShardedAVL
+{
+private:
+
+    // Own cache line per shard, so locks of neighbouring shards don't share one.
+    struct alignas(64) Shard
+    {
+        mutable std::shared_mutex mutex;
+        AVL<T> tree;
+        size_t size { 0 };
+    };
+
+    std::array<Shard, N> shards_;
+    [[no_unique_address]] Hash hash_;
+
+    Shard& shard_(const T& key)
+    {
+        // Fibonacci hashing spreads identity hashes of consecutive integers.
+        std::uint64_t h { static_cast<std::uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ull };
+        return shards_[(h >> 32) % N];
+    }
+
+    // Visit keys of all shards in order, from the iterator begin gives for each shard until stop(key).
+    template<typename Begin, typename Stop, typename F>
+    void merge_(Begin begin, Stop stop, F& fnc)
+    {
+        std::array<std::shared_lock<std::shared_mutex>, N> locks;
+        for ( size_t i {0}; i < N; ++i ) locks[i] = std::shared_lock { shards_[i].mutex };
+
+        std::array<InOrderIterator<T>, N> its { make_iterators_(begin, std::make_index_sequence<N>{}) };
+        // N is small, a linear scan for the smallest head is as fast as a heap.
+        while ( true )
+        {
+            size_t best { N };
+            for ( size_t i {0}; i < N; ++i )
+            {
+                if ( !its[i].node() ) continue;
+                if ( best == N || its[i].node()->data < its[best].node()->data ) best = i;
+            }
+            if ( best == N ) return;
+            const T& key { its[best].node()->data };
+            if ( stop(key) || !detail::visit(fnc, key) ) return;
+            ++its[best];
+        }
+    }
+
+    template<typename Begin, size_t... I>
+    std::array<InOrderIterator<T>, N> make_iterators_(Begin& begin, std::index_sequence<I...>)
+    {
+        return { begin(shards_[I].tree)... };
+    }
+
+public:
+
+    /*
+        Constructors
+    */
+    ShardedAVL() {}
+
+    ShardedAVL(const std::vector<T>& data) { for ( const T& key : data ) add(key); }
+
+    /*
+        Public member functions, all thread-safe.
+    */
+
+    void add(const T& key)
+    {
+        Shard& shard { shard_(key) };
+        std::unique_lock lock { shard.mutex };
+        shard.tree.add(key);
+        ++shard.size;
+    }
+
+    bool remove(const T& key)
+    {
+        Shard& shard { shard_(key) };
+        std::unique_lock lock { shard.mutex };
+        bool removed { shard.tree.remove(key) };
+        shard.size -= removed;
+        return removed;
+    }
+
+    std::optional<T> search(const T& key)
+    {
+        Shard& shard { shard_(key) };
+        std::shared_lock lock { shard.mutex };
+        return shard.tree.search(key);
+    }
+
+    bool contains(const T& key) { return search(key).has_value(); }
+
+    size_t size() const
+    {
+        size_t total { 0 };
+        for ( const Shard& shard : shards_ )
+        {
+            std::shared_lock lock { shard.mutex };
+            total += shard.size;
+        }
+        return total;
+    }
+
+    // Number of keys in each shard.
+    std::array<size_t, N> shard_sizes() const
+    {
+        std::array<size_t, N> sizes;
+        for ( size_t i {0}; i < N; ++i )
+        {
+            std::shared_lock lock { shards_[i].mutex };
+            sizes[i] = shards_[i].size;
+        }
+        return sizes;
+    }
+
+    /*
+        Call fnc for every key in order. If fnc returns tree::Visit, the
+        traversal ends after the first Visit::stop. Writers wait until the
+        traversal ends.
+    */
+    template<typename F>
+    void in_order(F fnc)
+    {
+        merge_([](AVL<T>& shard){ return shard.begin(); }, [](const T&){ return false; }, fnc);
+    }
+
+    // Call fnc for every key of [lo, hi] in order, like in_order.
+    template<typename F>
+    void range(const T& lo, const T& hi, F fnc)
+    {
+        merge_([&](AVL<T>& shard){ return shard.lower_bound(lo); }, [&](const T& key){ return hi < key; }, fnc);
+    }
+
+    std::vector<T> range(const T& lo, const T& hi)
+    {
+        std::vector<T> keys;
+        range(lo, hi, [&](const T& key){ keys.push_back(key); });
+        return keys;
+    }
+
+};
+
+}  // namespace tree
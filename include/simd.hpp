@@ -0,0 +1,326 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <optional>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <concepts>
+#include <cstdint>
+#include <bit>
+#include <new>
+
+#include "bst.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define TREE_SIMD_X86 1
+    #define TREE_TARGET(isa) __attribute__((target(isa)))
+    #include <immintrin.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+    #define TREE_SIMD_X86 1
+    #define TREE_TARGET(isa)
+    #include <intrin.h>
+    #include <immintrin.h>
+#else
+    #define TREE_TARGET(isa)
+#endif
+
+
+namespace tree
+{
+
+// Instruction set used to search blocks of a SimdSearchTree.
+enum class Isa : int
+{
+    scalar = 0,
+    sse = 1,    // SSE2 for 32-bit keys, SSE4.2 for 64-bit keys.
+    avx2 = 2,
+};
+
+// Best instruction set supported by the running CPU.
+inline Isa detect_isa()
+{
+#if defined(TREE_SIMD_X86) && defined(__GNUC__)
+    static const Isa isa { __builtin_cpu_supports("avx2")   ? Isa::avx2 :
+                           __builtin_cpu_supports("sse4.2") ? Isa::sse  : Isa::scalar };
+    return isa;
+#elif defined(TREE_SIMD_X86)
+    static const Isa isa { []{
+        int info[4];
+        __cpuidex(info, 0, 0);
+        int leaves { info[0] };
+        __cpuidex(info, 1, 0);
+        bool sse42   { (info[2] & (1 << 20)) != 0 };
+        bool osxsave { (info[2] & (1 << 27)) != 0 };
+        bool avx2    { false };
+        if ( leaves >= 7 && osxsave && (_xgetbv(0) & 0x6) == 0x6 )
+        {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+        }
+        return avx2 ? Isa::avx2 : sse42 ? Isa::sse : Isa::scalar;
+    }() };
+    return isa;
+#else
+    return Isa::scalar;
+#endif
+}
+
+
+namespace detail
+{
+
+// Number of keys in block smaller than key. Block holds 64 / sizeof(K) keys.
+template<typename K>
+inline unsigned count_less_scalar(const K* block, K key)
+{
+    constexpr unsigned B { 64 / sizeof(K) };
+    unsigned count { 0 };
+    for ( unsigned i {0}; i < B; ++i ) count += block[i] < key;
+    return count;
+}
+
+#if defined(TREE_SIMD_X86)
+
+TREE_TARGET("sse2")
+inline unsigned count_less_sse(const std::int32_t* block, std::int32_t key)
+{
+    __m128i x { _mm_set1_epi32(key) };
+    unsigned mask { 0 };
+    for ( int i {0}; i < 4; ++i )
+    {
+        __m128i keys { _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 4 * i)) };
+        mask |= static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(x, keys)))) << (4 * i);
+    }
+    return std::popcount(mask);
+}
+
+TREE_TARGET("sse4.2")
+inline unsigned count_less_sse(const std::int64_t* block, std::int64_t key)
+{
+    __m128i x { _mm_set1_epi64x(key) };
+    unsigned mask { 0 };
+    for ( int i {0}; i < 4; ++i )
+    {
+        __m128i keys { _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 2 * i)) };
+        mask |= static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(x, keys)))) << (2 * i);
+    }
+    return std::popcount(mask);
+}
+
+TREE_TARGET("avx2")
+inline unsigned count_less_avx2(const std::int32_t* block, std::int32_t key)
+{
+    __m256i x { _mm256_set1_epi32(key) };
+    __m256i lo { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)) };
+    __m256i hi { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 8)) };
+    unsigned mask_lo { static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, lo)))) };
+    unsigned mask_hi { static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, hi)))) };
+    return std::popcount(mask_lo | (mask_hi << 8));
+}
+
+TREE_TARGET("avx2")
+inline unsigned count_less_avx2(const std::int64_t* block, std::int64_t key)
+{
+    __m256i x { _mm256_set1_epi64x(key) };
+    __m256i lo { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)) };
+    __m256i hi { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 4)) };
+    unsigned mask_lo { static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(x, lo)))) };
+    unsigned mask_hi { static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(x, hi)))) };
+    return std::popcount(mask_lo | (mask_hi << 4));
+}
+
+#endif
+
+}  // namespace detail
+
+
+/*
+    Read-only k-ary search tree for integer keys (FAST / static B+ tree layout).
+
+    Every block is one cache line: 16 keys for 32-bit keys, 8 keys for 64-bit
+    keys. The last level is the sorted key array itself, padded to whole
+    blocks. Each internal block has B separator keys and B + 1 children, the
+    separator i being the smallest key of child i + 1. A search loads one
+    block per level and picks the child by counting keys smaller than the
+    searched key with a vector compare and movemask.
+
+    The instruction set is chosen at runtime, see detect_isa.
+*/
+template<typename K>
+requires (std::signed_integral<K> && (sizeof(K) == 4 || sizeof(K) == 8))
+class SimdSearchTree
+{
+public:
+
+    static constexpr size_t B { 64 / sizeof(K) };   // Keys per block.
+
+private:
+
+    using block_key = std::conditional_t<sizeof(K) == 4, std::int32_t, std::int64_t>;
+
+    struct Aligned_Delete
+    {
+        void operator()(K* ptr) const { ::operator delete[](ptr, std::align_val_t{64}); }
+    };
+
+    static constexpr K PAD { std::numeric_limits<K>::max() };
+
+    std::unique_ptr<K[], Aligned_Delete> keys_;
+    size_t size_ { 0 };
+    std::vector<size_t> offsets_;   // Offset of each level in keys_, root level first, leaves last.
+    Isa isa_ { detect_isa() };
+
+    unsigned count_less_(const K* block, K key) const
+    {
+        const block_key* b { reinterpret_cast<const block_key*>(block) };
+        switch ( isa_ )
+        {
+#if defined(TREE_SIMD_X86)
+        case Isa::avx2: return detail::count_less_avx2(b, static_cast<block_key>(key));
+        case Isa::sse:  return detail::count_less_sse(b, static_cast<block_key>(key));
+#endif
+        default:        return detail::count_less_scalar(b, static_cast<block_key>(key));
+        }
+    }
+
+    void build_(const std::vector<K>& sorted)
+    {
+        size_ = sorted.size();
+        // Number of blocks on each level, leaves first.
+        std::vector<size_t> blocks { std::max<size_t>(1, (size_ + B - 1) / B) };
+        while ( blocks.back() > 1 ) blocks.push_back((blocks.back() + B) / (B + 1));
+        std::reverse(blocks.begin(), blocks.end());
+
+        size_t total { 0 };
+        offsets_.clear();
+        for ( size_t count : blocks )
+        {
+            offsets_.push_back(total);
+            total += count * B;
+        }
+        keys_.reset(static_cast<K*>(::operator new[](total * sizeof(K), std::align_val_t{64})));
+        std::fill(keys_.get(), keys_.get() + total, PAD);
+
+        // Leaves.
+        std::copy(sorted.begin(), sorted.end(), keys_.get() + offsets_.back());
+
+        // Internal levels. Separator i of block p is the smallest key in subtree of
+        // child p * (B + 1) + i + 1, which is the first key of its leftmost leaf block.
+        size_t levels { blocks.size() };
+        for ( size_t level {0}; level + 1 < levels; ++level )
+        {
+            size_t span { 1 };   // Leaf blocks covered by one child of this level.
+            for ( size_t below { level + 1 }; below + 1 < levels; ++below ) span *= B + 1;
+            K* out { keys_.get() + offsets_[level] };
+            for ( size_t p {0}; p < blocks[level]; ++p )
+            {
+                for ( size_t i {0}; i < B; ++i )
+                {
+                    size_t leaf_block { (p * (B + 1) + i + 1) * span };
+                    size_t index { leaf_block * B };
+                    out[p * B + i] = index < size_ ? sorted[index] : PAD;
+                }
+            }
+        }
+    }
+
+public:
+
+    /*
+        Constructors
+    */
+    SimdSearchTree() { build_({}); }
+
+    // Keys must be sorted.
+    SimdSearchTree(const std::vector<K>& sorted) { build_(sorted); }
+
+    // Keys must be sorted.
+    template<std::input_iterator It>
+    SimdSearchTree(It first, It last) { build_(std::vector<K>(first, last)); }
+
+    template<typename S>
+    SimdSearchTree(BST<K, S>& search_tree)
+    {
+        build_(std::vector<K>(search_tree.begin(), search_tree.end()));
+    }
+
+    /*
+        Public member functions
+    */
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    Isa isa() const { return isa_; }
+
+    // Force an instruction set, limited to what the CPU supports.
+    void isa(Isa isa) { isa_ = std::min(isa, detect_isa()); }
+
+    // Number of keys smaller than key.
+    size_t rank(K key) const
+    {
+        size_t k { 0 };
+        const K* base { keys_.get() };
+        for ( size_t level {0}; level + 1 < offsets_.size(); ++level )
+            k = k * (B + 1) + count_less_(base + offsets_[level] + k * B, key);
+        size_t position { k * B + count_less_(base + offsets_.back() + k * B, key) };
+        return std::min(position, size_);
+    }
+
+    // Smallest key not less than key.
+    std::optional<K> lower_bound(K key) const
+    {
+        size_t position { rank(key) };
+        if ( position == size_ ) return std::nullopt;
+        return (*this)[position];
+    }
+
+    bool contains(K key) const
+    {
+        size_t position { rank(key) };
+        return position < size_ && (*this)[position] == key;
+    }
+
+    // Number of keys not greater than key.
+    size_t count_up_to(K key) const
+    {
+        return key == std::numeric_limits<K>::max() ? size_ : rank(key + 1);
+    }
+
+    std::optional<K> ceiling(K key) const { return lower_bound(key); }
+
+    // Smallest key greater than key.
+    std::optional<K> successor(K key) const
+    {
+        size_t position { count_up_to(key) };
+        if ( position == size_ ) return std::nullopt;
+        return (*this)[position];
+    }
+
+    // Largest key not greater than key.
+    std::optional<K> floor(K key) const
+    {
+        size_t count { count_up_to(key) };
+        if ( count == 0 ) return std::nullopt;
+        return (*this)[count - 1];
+    }
+
+    // Largest key smaller than key.
+    std::optional<K> predecessor(K key) const
+    {
+        size_t count { rank(key) };
+        if ( count == 0 ) return std::nullopt;
+        return (*this)[count - 1];
+    }
+
+    // Key closest to key, the smaller one on ties.
+    std::optional<K> nearest(K key) const { return detail::nearer(key, floor(key), ceiling(key)); }
+
+    // Key of given rank.
+    K operator[](size_t position) const { return keys_[offsets_.back() + position]; }
+
+};
+
+}  // namespace tree
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "trace.hpp"
+
+
+namespace tree
+{
+
+/*
+    Point-in-time snapshots of a BST or AVL with integer keys, written by a
+    background thread while writers go on.
+
+    Snapshotting forwards operations to the tree under a mutex. snapshot_to
+    only marks the start of a snapshot; a background thread then walks the
+    tree in order, SLICE keys at a time under the mutex, and writes each
+    slice to the file with the mutex released. Writers wait for one slice at
+    most, never for the disk.
+
+    The walk sees changes made after the mark, so writers record how they
+    changed keys the walk hasn't reached yet (keys after the cursor). For
+    every key the walk writes as many copies as the tree had at the mark:
+    copies it finds minus the recorded adds plus the recorded removes. Keys
+    before the cursor are already written and need nothing.
+
+    The file is a trace of adds in key order (see trace.hpp), load_snapshot
+    rebuilds the tree from it.
+
+        tree::AVL<int> search_tree;
+        tree::Snapshotting snapshots { search_tree };
+        auto written { snapshots.snapshot_to("backup.trc") };
+        snapshots.add(7);                      // Not in the snapshot.
+        written.get();                         // Number of keys in the snapshot.
+
+    One snapshot runs at a time. snapshot_to and wait shouldn't be called
+    from several threads at once; the other member functions can be.
+*/
+template<typename Tree>
+class Snapshotting
+{
+public:
+
+    using key_type = std::remove_cvref_t<decltype(*std::declval<Tree&>().min())>;
+
+    // Keys the background thread takes at once.
+    static constexpr size_t SLICE { 256 };
+
+private:
+
+    Tree& tree_;
+    std::mutex mutex_;
+
+    // State of the running snapshot, guarded by mutex_.
+    bool active_ { false };
+    std::optional<key_type> cursor_;            // Last key written, nullopt before the first one.
+    std::map<key_type, long long> changes_;     // Copies added minus copies removed, of keys after cursor_.
+
+    std::thread thread_;
+
+    void changed_(const key_type& key, long long copies)
+    {
+        if ( !active_ || (cursor_ && !(*cursor_ < key)) ) return;
+        auto [it, inserted] { changes_.try_emplace(key, 0) };
+        if ( (it->second += copies) == 0 ) changes_.erase(it);
+    }
+
+    // Append copies of key the tree had at the mark, given copies it has now. Key is a copy, it may be erased from changes_.
+    void emit_(std::vector<key_type>& out, key_type key, long long now)
+    {
+        auto change { changes_.find(key) };
+        if ( change != changes_.end() )
+        {
+            now -= change->second;
+            changes_.erase(change);
+        }
+        out.insert(out.end(), static_cast<size_t>(now), key);
+    }
+
+    // Keys of the snapshot following cursor_, moves cursor_ past them. Empty at the end. Caller holds mutex_.
+    std::vector<key_type> next_slice_()
+    {
+        std::vector<key_type> slice;
+        auto it { cursor_ ? tree_.lower_bound(*cursor_) : tree_.begin() };
+        while ( it != tree_.end() && cursor_ && !(*cursor_ < *it) ) ++it;
+
+        size_t taken { 0 };
+        while ( it != tree_.end() && taken < SLICE )
+        {
+            key_type key { *it };
+            long long copies { 0 };
+            for ( ; it != tree_.end() && !(key < *it); ++it ) ++copies;   // All copies in one slice.
+            taken += copies;
+            // Keys removed since the mark, which the walk doesn't find.
+            while ( !changes_.empty() && changes_.begin()->first < key )
+                emit_(slice, changes_.begin()->first, 0);
+            emit_(slice, key, copies);
+            cursor_ = key;
+        }
+        if ( it == tree_.end() )
+        {
+            while ( !changes_.empty() ) emit_(slice, changes_.begin()->first, 0);
+            active_ = false;
+        }
+        return slice;
+    }
+
+    void write_(std::filesystem::path path, std::promise<size_t> done)
+    {
+        try
+        {
+            std::ofstream out { path, std::ios::binary | std::ios::trunc };
+            if ( !out ) throw std::runtime_error("snapshot: cannot open " + path.string());
+            TraceWriter<key_type> writer { out };
+            size_t written { 0 };
+            bool more { true };
+            while ( more )
+            {
+                std::vector<key_type> slice;
+                {
+                    std::lock_guard lock { mutex_ };
+                    slice = next_slice_();
+                    more = active_;
+                }
+                for ( const key_type& key : slice ) writer.write(Op::add, key);
+                written += slice.size();
+            }
+            out.flush();
+            if ( !out ) throw std::runtime_error("snapshot: cannot write " + path.string());
+            done.set_value(written);
+        }
+        catch ( ... )
+        {
+            {
+                std::lock_guard lock { mutex_ };
+                active_ = false;
+                changes_.clear();
+            }
+            done.set_exception(std::current_exception());
+        }
+    }
+
+public:
+
+    /*
+        Constructors
+    */
+    explicit Snapshotting(Tree& tree) : tree_{tree} {}
+
+    Snapshotting(const Snapshotting& other) = delete;
+    Snapshotting& operator=(const Snapshotting& other) = delete;
+
+    ~Snapshotting() { wait(); }
+
+    /*
+        Public member functions
+    */
+
+    void add(key_type key)
+    {
+        std::lock_guard lock { mutex_ };
+        tree_.add(key);
+        changed_(key, 1);
+    }
+
+    bool remove(key_type key)
+    {
+        std::lock_guard lock { mutex_ };
+        bool removed { tree_.remove(key) };
+        if ( removed ) changed_(key, -1);
+        return removed;
+    }
+
+    std::optional<key_type> extract_min()
+    {
+        std::lock_guard lock { mutex_ };
+        auto key { tree_.extract_min() };
+        if ( key ) changed_(*key, -1);
+        return key;
+    }
+
+    std::optional<key_type> extract_max()
+    {
+        std::lock_guard lock { mutex_ };
+        auto key { tree_.extract_max() };
+        if ( key ) changed_(*key, -1);
+        return key;
+    }
+
+    std::optional<key_type> search(key_type key)
+    {
+        std::lock_guard lock { mutex_ };
+        return tree_.search(key);
+    }
+
+    /*
+        Start writing the tree as it is now to path, in the background. The
+        future gives the number of keys written, or the error. Throws
+        std::logic_error if a snapshot is running.
+    */
+    std::future<size_t> snapshot_to(const std::filesystem::path& path)
+    {
+        {
+            std::lock_guard lock { mutex_ };
+            if ( active_ ) throw std::logic_error("snapshot: a snapshot is already running");
+        }
+        wait();
+        {
+            std::lock_guard lock { mutex_ };
+            active_ = true;
+            cursor_.reset();
+            changes_.clear();
+        }
+        std::promise<size_t> done;
+        std::future<size_t> written { done.get_future() };
+        thread_ = std::thread(&Snapshotting::write_, this, path, std::move(done));
+        return written;
+    }
+
+    // Wait for the running snapshot to finish.
+    void wait()
+    {
+        if ( thread_.joinable() ) thread_.join();
+    }
+
+    // The tree, not guarded by the mutex.
+    Tree& tree() { return tree_; }
+
+};
+
+// Add keys of a snapshot written by Snapshotting to a tree. Keys come in order, so they go to the cached end of the tree.
+template<typename Tree>
+void load_snapshot(Tree& tree, const std::filesystem::path& path)
+{
+    using key_type = typename Snapshotting<Tree>::key_type;
+    std::ifstream in { path, std::ios::binary };
+    if ( !in ) throw std::runtime_error("snapshot: cannot open " + path.string());
+    TraceReader<key_type> reader { in };
+    while ( auto event { reader.next() } )
+        if ( event->op == Op::add ) tree.add(event->key);
+}
+
+}  // namespace tree
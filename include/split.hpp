@@ -0,0 +1,339 @@
+#pragma once
+
+#include <vector>
+#include <stack>
+#include <optional>
+#include <functional>
+#include <type_traits>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+
+namespace tree
+{
+
+/*
+    Self-balancing (AVL) search tree with hot/cold split of keys and payloads.
+
+    Keys and child links live in a compact array of "hot" nodes, the payloads in
+    a separate "cold" array. Both arrays are joined by index: hot node i describes
+    the payload at cold_[i]. Search walks only the hot array and touches a payload
+    only for the matching node. Iteration touches a payload only when the iterator
+    is dereferenced.
+
+    KeyOf extracts the key from a payload, for example
+
+        struct Key { int operator()(const My_Data& d) const { return d.key; } };
+        tree::SplitAVL<My_Data, Key> split_tree;
+
+    Like BST, keys smaller or equal than node's key go to the left.
+*/
+template<typename T, typename KeyOf = std::identity>
+class SplitAVL
+{
+public:
+
+    using key_type   = std::remove_cvref_t<std::invoke_result_t<KeyOf, const T&>>;
+    using index_type = std::uint32_t;
+
+    static constexpr index_type null { std::numeric_limits<index_type>::max() };
+
+private:
+
+    struct Hot
+    {
+        key_type key;
+        index_type left  { null };
+        index_type right { null };
+        std::int32_t height { 1 };
+    };
+
+    std::vector<Hot> hot_;
+    std::vector<std::optional<T>> cold_;
+    std::vector<index_type> free_;      // Slots released by remove, reused by add.
+    index_type root_ { null };
+    std::size_t size_ { 0 };
+    [[no_unique_address]] KeyOf key_of_ {};
+
+    std::int32_t height_(index_type i) const { return i == null ? 0 : hot_[i].height; }
+
+    void update_height_(index_type i)
+    {
+        hot_[i].height = std::max(height_(hot_[i].left), height_(hot_[i].right)) + 1;
+    }
+
+    std::int32_t skew_(index_type i) const
+    {
+        return i == null ? 0 : height_(hot_[i].right) - height_(hot_[i].left);
+    }
+
+    index_type rotate_left_(index_type i)
+    {
+        index_type r { hot_[i].right };
+        hot_[i].right = hot_[r].left;
+        hot_[r].left = i;
+        update_height_(i);
+        update_height_(r);
+        return r;
+    }
+
+    index_type rotate_right_(index_type i)
+    {
+        index_type l { hot_[i].left };
+        hot_[i].left = hot_[l].right;
+        hot_[l].right = i;
+        update_height_(i);
+        update_height_(l);
+        return l;
+    }
+
+    index_type balance_(index_type i)
+    {
+        if ( i == null ) return null;
+        update_height_(i);
+        switch ( skew_(i) )
+        {
+        case 2:  // Right heavy
+            if ( skew_(hot_[i].right) <= -1 ) hot_[i].right = rotate_right_(hot_[i].right);
+            return rotate_left_(i);
+        case -2:  // Left heavy
+            if ( skew_(hot_[i].left) >= 1 ) hot_[i].left = rotate_left_(hot_[i].left);
+            return rotate_right_(i);
+        default:
+            return i;
+        }
+    }
+
+    index_type allocate_(T&& data)
+    {
+        key_type key { key_of_(data) };
+        if ( !free_.empty() )
+        {
+            index_type i { free_.back() };
+            free_.pop_back();
+            hot_[i] = Hot{ std::move(key) };
+            cold_[i].emplace(std::move(data));
+            return i;
+        }
+        hot_.push_back(Hot{ std::move(key) });
+        cold_.emplace_back(std::move(data));
+        return static_cast<index_type>(hot_.size() - 1);
+    }
+
+    void release_(index_type i)
+    {
+        cold_[i].reset();
+        free_.push_back(i);
+    }
+
+    // Recursive helper member function for adding nodes. Returns new subtree root.
+    index_type add_(index_type node, index_type fresh)
+    {
+        if ( node == null ) return fresh;
+        if ( hot_[fresh].key <= hot_[node].key ) hot_[node].left  = add_(hot_[node].left,  fresh);
+        else                                     hot_[node].right = add_(hot_[node].right, fresh);
+        return balance_(node);
+    }
+
+    // Detach the minimum of a subtree. Returns new subtree root, minimum is stored in min.
+    index_type extract_min_(index_type node, index_type& min)
+    {
+        if ( hot_[node].left == null )
+        {
+            min = node;
+            return hot_[node].right;
+        }
+        hot_[node].left = extract_min_(hot_[node].left, min);
+        return balance_(node);
+    }
+
+    // Recursive helper member function to delete node by its key. Returns new subtree root.
+    index_type remove_(index_type node, const key_type& key, bool& removed)
+    {
+        if ( node == null ) return null;
+        Hot& it { hot_[node] };
+        if ( key == it.key )
+        {
+            removed = true;
+            index_type left  { it.left  };
+            index_type right { it.right };
+            release_(node);
+            if ( left  == null ) return right;
+            if ( right == null ) return left;
+            // Splice the successor in place of the removed node. Payloads stay put,
+            // only links are rewired.
+            index_type successor { null };
+            right = extract_min_(right, successor);
+            hot_[successor].left  = left;
+            hot_[successor].right = right;
+            return balance_(successor);
+        }
+        if ( key < it.key ) it.left  = remove_(it.left,  key, removed);
+        else                it.right = remove_(it.right, key, removed);
+        return balance_(node);
+    }
+
+    index_type find_(const key_type& key) const
+    {
+        index_type i { root_ };
+        while ( i != null )
+        {
+            const Hot& it { hot_[i] };
+            if ( key == it.key ) return i;
+            i = key < it.key ? it.left : it.right;
+        }
+        return null;
+    }
+
+public:
+
+    /*
+        In-order iterator. Walks only the hot array, payload is read on dereference.
+    */
+    class Iterator
+    {
+    private:
+
+        const SplitAVL* tree_ { nullptr };
+        std::stack<index_type, std::vector<index_type>> stack_;
+
+        void push_left_(index_type i)
+        {
+            while ( i != null )
+            {
+                stack_.push(i);
+                i = tree_->hot_[i].left;
+            }
+        }
+
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        Iterator(const SplitAVL* tree, index_type root)
+            : tree_{tree}
+        {
+            if ( tree_ ) push_left_(root);
+        }
+
+        reference operator*() const { return *tree_->cold_[stack_.top()]; }
+        pointer operator->() const { return &**this; }
+
+        // Key of the current element, does not touch the payload.
+        const key_type& key() const { return tree_->hot_[stack_.top()].key; }
+
+        Iterator& operator++()
+        {
+            index_type i { stack_.top() };
+            stack_.pop();
+            push_left_(tree_->hot_[i].right);
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator temp { *this };
+            ++(*this);
+            return temp;
+        }
+
+        bool operator==(const Iterator& other) const
+        {
+            if ( stack_.empty() || other.stack_.empty() ) return stack_.empty() && other.stack_.empty();
+            return stack_.top() == other.stack_.top();
+        }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+    };
+
+    /*
+        Constructors
+    */
+    SplitAVL() {}
+
+    explicit SplitAVL(KeyOf key_of) : key_of_{std::move(key_of)} {}
+
+    SplitAVL(std::vector<T> data)
+    {
+        reserve(data.size());
+        for ( auto& item : data ) add(std::move(item));
+    }
+
+    /*
+        Public member functions
+    */
+
+    void reserve(std::size_t capacity)
+    {
+        hot_.reserve(capacity);
+        cold_.reserve(capacity);
+    }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::size_t height() const { return static_cast<std::size_t>(height_(root_)); }
+
+    void add(T data)
+    {
+        index_type fresh { allocate_(std::move(data)) };
+        root_ = add_(root_, fresh);
+        ++size_;
+    }
+
+    // Touches only hot nodes.
+    bool contains(const key_type& key) const
+    {
+        return find_(key) != null;
+    }
+
+    // Touches hot nodes and the payload of the match.
+    std::optional<T> search(const key_type& key) const
+    {
+        index_type i { find_(key) };
+        if ( i == null ) return std::nullopt;
+        return *cold_[i];
+    }
+
+    // Pointer to the stored payload, or nullptr. Valid until the next add or remove.
+    const T* find(const key_type& key) const
+    {
+        index_type i { find_(key) };
+        return i == null ? nullptr : &*cold_[i];
+    }
+
+    bool remove(const key_type& key)
+    {
+        bool removed { false };
+        root_ = remove_(root_, key, removed);
+        if ( removed ) --size_;
+        return removed;
+    }
+
+    std::optional<key_type> min() const
+    {
+        if ( root_ == null ) return std::nullopt;
+        index_type i { root_ };
+        while ( hot_[i].left != null ) i = hot_[i].left;
+        return hot_[i].key;
+    }
+
+    std::optional<key_type> max() const
+    {
+        if ( root_ == null ) return std::nullopt;
+        index_type i { root_ };
+        while ( hot_[i].right != null ) i = hot_[i].right;
+        return hot_[i].key;
+    }
+
+    // Iteration
+
+    Iterator begin() const { return Iterator(this, root_); }
+    Iterator end() const { return Iterator(nullptr, null); }
+
+};
+
+}  // namespace tree
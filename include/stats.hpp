@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+
+
+namespace tree
+{
+
+/*
+    Instrumentation policies of BST and AVL.
+
+    A tree calls the policy on every counted event. NoStats ignores all of them
+    and takes no space in the tree (it's empty and stored as
+    [[no_unique_address]]), so an uninstrumented tree costs nothing.
+    CountingStats counts them.
+
+        tree::AVL<int, tree::CountingStats> search_tree;
+        ...
+        tree::Counters counters { search_tree.stats() };
+*/
+
+// Snapshot of counters of one tree.
+struct Counters
+{
+    std::uint64_t comparisons { 0 };  // Nodes compared with a key while descending in search and add.
+    std::uint64_t rotations   { 0 };  // Single rotations, a double rotation counts as two.
+    std::uint64_t balances    { 0 };  // Invocations of AVL balancing of a node.
+    std::uint64_t allocations { 0 };  // Nodes allocated.
+    std::uint64_t frees       { 0 };  // Nodes freed by remove and extract.
+    std::uint64_t max_depth   { 0 };  // Deepest descent of search or add, root is at depth 1.
+};
+
+struct NoStats
+{
+    static constexpr bool enabled { false };
+
+    void comparison() {}
+    void rotation() {}
+    void balance() {}
+    void allocation() {}
+    void free() {}
+    void descent(std::uint64_t) {}
+
+    Counters snapshot() const { return {}; }
+    void reset() {}
+};
+
+class CountingStats
+{
+private:
+
+    Counters counters_;
+
+public:
+
+    static constexpr bool enabled { true };
+
+    void comparison() { ++counters_.comparisons; }
+    void rotation()   { ++counters_.rotations; }
+    void balance()    { ++counters_.balances; }
+    void allocation() { ++counters_.allocations; }
+    void free()       { ++counters_.frees; }
+    void descent(std::uint64_t depth) { counters_.max_depth = std::max(counters_.max_depth, depth); }
+
+    Counters snapshot() const { return counters_; }
+    void reset() { counters_ = {}; }
+};
+
+}  // namespace tree
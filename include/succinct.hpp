@@ -0,0 +1,269 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "linked.hpp"
+
+
+namespace tree
+{
+
+/*
+    Bit vector with rank and select.
+
+    rank1 counts ones in a 512-bit block from the cumulative count stored
+    for the block and popcounts of at most 7 words: O(1). select1 starts at
+    the block sampled for every 512th one and scans forward; in vectors with
+    a fair share of ones that's a block or two.
+*/
+class RankSelect
+{
+private:
+
+    static constexpr size_t WORDS_PER_BLOCK { 8 };
+    static constexpr size_t ONES_PER_SAMPLE { 512 };
+
+    std::vector<std::uint64_t> words_;
+    size_t size_ { 0 };
+    std::vector<std::uint64_t> blocks_;     // Ones before each block.
+    std::vector<std::uint32_t> samples_;    // Block holding one number i * ONES_PER_SAMPLE + 1.
+    size_t ones_ { 0 };
+
+public:
+
+    RankSelect() {}
+
+    void push_back(bool bit)
+    {
+        if ( size_ % 64 == 0 ) words_.push_back(0);
+        if ( bit ) words_.back() |= std::uint64_t{1} << (size_ % 64);
+        ++size_;
+    }
+
+    // Build the rank and select directories, after the last push_back.
+    void index()
+    {
+        blocks_.assign(words_.size() / WORDS_PER_BLOCK + 1, 0);
+        samples_.clear();
+        ones_ = 0;
+        for ( size_t w {0}; w < words_.size(); ++w )
+        {
+            if ( w % WORDS_PER_BLOCK == 0 ) blocks_[w / WORDS_PER_BLOCK] = ones_;
+            size_t count { static_cast<size_t>(std::popcount(words_[w])) };
+            // Samples for the ones falling into this word.
+            while ( samples_.size() * ONES_PER_SAMPLE < ones_ + count )
+                samples_.push_back(static_cast<std::uint32_t>(w / WORDS_PER_BLOCK));
+            ones_ += count;
+        }
+        if ( words_.size() % WORDS_PER_BLOCK == 0 ) blocks_.back() = ones_;
+    }
+
+    size_t size() const { return size_; }
+    size_t ones() const { return ones_; }
+
+    bool operator[](size_t i) const { return (words_[i / 64] >> (i % 64)) & 1; }
+
+    // Ones in positions [0, i).
+    size_t rank1(size_t i) const
+    {
+        size_t w { i / 64 };
+        size_t block { w / WORDS_PER_BLOCK };
+        size_t count { blocks_[block] };
+        for ( size_t k { block * WORDS_PER_BLOCK }; k < w; ++k ) count += std::popcount(words_[k]);
+        if ( i % 64 ) count += std::popcount(words_[w] & ((std::uint64_t{1} << (i % 64)) - 1));
+        return count;
+    }
+
+    // Position of the j-th one, 1-based. j must be in [1, ones()].
+    size_t select1(size_t j) const
+    {
+        size_t block { samples_[(j - 1) / ONES_PER_SAMPLE] };
+        while ( block + 1 < blocks_.size() && blocks_[block + 1] < j ) ++block;
+        size_t rest { j - blocks_[block] };
+        size_t w { block * WORDS_PER_BLOCK };
+        for ( size_t count; (count = std::popcount(words_[w])) < rest; ++w ) rest -= count;
+        std::uint64_t word { words_[w] };
+        for ( ; rest > 1; --rest ) word &= word - 1;   // Clear the lower ones.
+        return w * 64 + std::countr_zero(word);
+    }
+
+    // Bytes held, directories included.
+    size_t memory() const
+    {
+        return words_.size() * sizeof(std::uint64_t) + blocks_.size() * sizeof(std::uint64_t)
+             + samples_.size() * sizeof(std::uint32_t);
+    }
+
+    const std::vector<std::uint64_t>& words() const { return words_; }
+
+    // Set the bits from words, then index.
+    void assign(std::vector<std::uint64_t> words, size_t size)
+    {
+        words_ = std::move(words);
+        size_ = size;
+        index();
+    }
+
+};
+
+/*
+    Read-only binary tree of 2n + 1 bits of shape plus n values.
+
+    The shape is the level-order bitmap of the tree (Jacobson): a one for the
+    root, then two bits for every node in level order, telling whether it has
+    a left and a right child. Values are stored in the same level order.
+
+    Nodes are numbered 1 .. n in level order, 0 meaning no node. The child
+    bits of node k are at positions 2k - 1 and 2k, and a child whose bit is
+    at position p is node rank1(p + 1). So left and right are one rank each,
+    O(1); parent is a select. subtree_size walks the subtree level by level,
+    where its nodes are always a contiguous range of numbers: O(height).
+
+        auto root { tree::deserialize<int>(file) };
+        tree::SuccinctTree<int> compact { root };
+        size_t k { compact.left(compact.root()) };
+        int value { compact[k] };
+*/
+template<typename T>
+class SuccinctTree
+{
+private:
+
+    RankSelect shape_;
+    std::vector<T> values_;
+
+    static constexpr char MAGIC[4] { 'S', 'B', 'T', '1' };
+
+    // Node of child bit at position, 0 if the bit is clear.
+    size_t child_(size_t position) const { return shape_[position] ? shape_.rank1(position + 1) : 0; }
+
+public:
+
+    /*
+        Constructors
+    */
+    SuccinctTree() {}
+
+    SuccinctTree(const std::unique_ptr<Node<T>>& root)
+    {
+        if ( !root ) return;
+        shape_.push_back(true);
+        std::queue<const Node<T>*> nodes;
+        nodes.push(root.get());
+        while ( !nodes.empty() )
+        {
+            const Node<T>* node { nodes.front() };
+            nodes.pop();
+            values_.push_back(node->data);
+            shape_.push_back(static_cast<bool>(node->left()));
+            shape_.push_back(static_cast<bool>(node->right()));
+            if ( node->left() )  nodes.push(node->left().get());
+            if ( node->right() ) nodes.push(node->right().get());
+        }
+        shape_.index();
+    }
+
+    /*
+        Public member functions
+    */
+
+    size_t size() const { return values_.size(); }
+    bool empty() const { return values_.empty(); }
+
+    size_t root() const { return empty() ? 0 : 1; }
+    size_t left(size_t k) const { return child_(2 * k - 1); }
+    size_t right(size_t k) const { return child_(2 * k); }
+    size_t parent(size_t k) const { return k > 1 ? (shape_.select1(k) + 1) / 2 : 0; }
+    bool is_leaf(size_t k) const { return !shape_[2 * k - 1] && !shape_[2 * k]; }
+
+    const T& operator[](size_t k) const { return values_[k - 1]; }
+    T& operator[](size_t k) { return values_[k - 1]; }
+
+    // Nodes in the subtree of node k.
+    size_t subtree_size(size_t k) const
+    {
+        size_t total { 0 };
+        // Nodes of one level of the subtree are first .. last; their children follow them on the next level.
+        for ( size_t first {k}, last {k}; first <= last; )
+        {
+            total += last - first + 1;
+            first = shape_.rank1(2 * first - 1) + 1;
+            last = shape_.rank1(2 * last + 1);
+        }
+        return total;
+    }
+
+    // Rebuild the pointer tree.
+    std::unique_ptr<Node<T>> to_nodes() const
+    {
+        if ( empty() ) return nullptr;
+        std::vector<Node<T>*> nodes(size() + 1, nullptr);
+        auto root { std::make_unique<Node<T>>(values_[0]) };
+        nodes[1] = root.get();
+        for ( size_t k {1}; k <= size(); ++k )
+        {
+            if ( size_t child { left(k) } )  nodes[child] = nodes[k]->left(std::make_unique<Node<T>>(values_[child - 1])).get();
+            if ( size_t child { right(k) } ) nodes[child] = nodes[k]->right(std::make_unique<Node<T>>(values_[child - 1])).get();
+        }
+        return root;
+    }
+
+    // Bytes held by shape and values.
+    size_t memory() const { return shape_.memory() + values_.size() * sizeof(T); }
+
+    const RankSelect& shape() const { return shape_; }
+
+    /*
+        Binary format: "SBT1", u32 size of a value, u64 number of nodes, shape
+        words, values. Values are stored as they are in memory, so T must be
+        trivially copyable and the file is read on a machine of the same byte
+        order, as a tree of values of the same size.
+    */
+    void save(std::ostream& out) const
+    requires std::is_trivially_copyable_v<T>
+    {
+        out.write(MAGIC, 4);
+        std::uint32_t value_size { sizeof(T) };
+        out.write(reinterpret_cast<const char*>(&value_size), sizeof(value_size));
+        std::uint64_t count { size() };
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        const auto& words { shape_.words() };
+        out.write(reinterpret_cast<const char*>(words.data()), static_cast<std::streamsize>(words.size() * sizeof(std::uint64_t)));
+        out.write(reinterpret_cast<const char*>(values_.data()), static_cast<std::streamsize>(values_.size() * sizeof(T)));
+    }
+
+    static SuccinctTree load(std::istream& in)
+    requires std::is_trivially_copyable_v<T>
+    {
+        char magic[4];
+        std::uint32_t value_size { 0 };
+        std::uint64_t count { 0 };
+        if ( !in.read(magic, 4) || std::string(magic, 4) != std::string(MAGIC, 4) )
+            throw std::runtime_error("SuccinctTree: not a succinct tree");
+        if ( !in.read(reinterpret_cast<char*>(&value_size), sizeof(value_size)) ) throw std::runtime_error("SuccinctTree: truncated");
+        if ( value_size != sizeof(T) ) throw std::runtime_error("SuccinctTree: values are of a different size");
+        if ( !in.read(reinterpret_cast<char*>(&count), sizeof(count)) ) throw std::runtime_error("SuccinctTree: truncated");
+        SuccinctTree result;
+        if ( count == 0 ) return result;
+        size_t bits { 2 * count + 1 };
+        std::vector<std::uint64_t> words((bits + 63) / 64);
+        result.values_.resize(count);
+        in.read(reinterpret_cast<char*>(words.data()), static_cast<std::streamsize>(words.size() * sizeof(std::uint64_t)));
+        in.read(reinterpret_cast<char*>(result.values_.data()), static_cast<std::streamsize>(count * sizeof(T)));
+        if ( !in ) throw std::runtime_error("SuccinctTree: truncated");
+        result.shape_.assign(std::move(words), bits);
+        if ( result.shape_.ones() != count ) throw std::runtime_error("SuccinctTree: shape doesn't match the number of nodes");
+        return result;
+    }
+
+};
+
+}  // namespace tree
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <cstdint>
+
+
+namespace tree
+{
+
+/*
+    Workload traces.
+
+    Recorder wraps a tree and logs every add, search, remove and extract made
+    through it into a compact binary trace. The trace can be replayed later
+    (see bench/src/replay.cpp) against any tree implementation.
+
+    Trace layout:
+        "TRC1"        magic
+        u8            size of key in bytes
+        records       u8 operation, followed by the key for add, search and remove
+
+    Keys are stored as zigzag varint of difference to the previous key, so
+    local or monotonic traffic takes one or two bytes per key.
+*/
+
+enum class Op : std::uint8_t
+{
+    add = 0,
+    search = 1,
+    remove = 2,
+    extract_min = 3,
+    extract_max = 4,
+};
+
+inline bool has_key(Op op) { return op == Op::add || op == Op::search || op == Op::remove; }
+
+template<typename K>
+struct Event
+{
+    Op op;
+    K key {};
+};
+
+template<typename K>
+requires std::is_integral_v<K>
+class TraceWriter
+{
+private:
+
+    std::ostream& out_;
+    std::int64_t previous_ { 0 };
+
+    void write_varint_(std::uint64_t value)
+    {
+        char bytes[10];
+        int count { 0 };
+        while ( value >= 0x80 )
+        {
+            bytes[count++] = static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        bytes[count++] = static_cast<char>(value);
+        out_.write(bytes, count);
+    }
+
+public:
+
+    explicit TraceWriter(std::ostream& out)
+        : out_{out}
+    {
+        out_.write("TRC1", 4);
+        out_.put(static_cast<char>(sizeof(K)));
+    }
+
+    void write(Op op, K key = {})
+    {
+        out_.put(static_cast<char>(op));
+        if ( !has_key(op) ) return;
+        std::int64_t value { static_cast<std::int64_t>(key) };
+        std::uint64_t delta { static_cast<std::uint64_t>(value) - static_cast<std::uint64_t>(previous_) };
+        std::int64_t signed_delta { static_cast<std::int64_t>(delta) };
+        // Zigzag: small negative and positive differences get small codes.
+        write_varint_((delta << 1) ^ static_cast<std::uint64_t>(signed_delta >> 63));
+        previous_ = value;
+    }
+
+};
+
+template<typename K>
+requires std::is_integral_v<K>
+class TraceReader
+{
+private:
+
+    std::istream& in_;
+    std::int64_t previous_ { 0 };
+
+    std::uint64_t read_varint_()
+    {
+        std::uint64_t value { 0 };
+        for ( int shift {0}; shift < 64; shift += 7 )
+        {
+            int byte { in_.get() };
+            if ( byte == std::char_traits<char>::eof() ) throw std::runtime_error("trace: truncated record");
+            value |= std::uint64_t(byte & 0x7F) << shift;
+            if ( !(byte & 0x80) ) return value;
+        }
+        throw std::runtime_error("trace: invalid varint");
+    }
+
+public:
+
+    explicit TraceReader(std::istream& in)
+        : in_{in}
+    {
+        char magic[4];
+        if ( !in_.read(magic, 4) || std::string(magic, 4) != "TRC1" )
+            throw std::runtime_error("trace: not a trace");
+        if ( in_.get() != static_cast<int>(sizeof(K)) )
+            throw std::runtime_error("trace: key size mismatch");
+    }
+
+    // Next event, nullopt at the end of trace.
+    std::optional<Event<K>> next()
+    {
+        int op { in_.get() };
+        if ( op == std::char_traits<char>::eof() ) return std::nullopt;
+        if ( op > static_cast<int>(Op::extract_max) ) throw std::runtime_error("trace: unknown operation");
+        Event<K> event { static_cast<Op>(op) };
+        if ( has_key(event.op) )
+        {
+            std::uint64_t zigzag { read_varint_() };
+            std::uint64_t delta { (zigzag >> 1) ^ (~(zigzag & 1) + 1) };
+            previous_ = static_cast<std::int64_t>(static_cast<std::uint64_t>(previous_) + delta);
+            event.key = static_cast<K>(previous_);
+        }
+        return event;
+    }
+
+};
+
+/*
+    Forwards operations to a BST or AVL and records them.
+
+        tree::AVL<int> search_tree;
+        std::ofstream file { "traffic.trc", std::ios::binary };
+        tree::Recorder recorder { search_tree, file };
+        recorder.add(7);
+*/
+template<typename Tree>
+class Recorder
+{
+private:
+
+    using key_type = std::remove_cvref_t<decltype(*std::declval<Tree&>().min())>;
+
+    Tree& tree_;
+    TraceWriter<key_type> writer_;
+
+public:
+
+    Recorder(Tree& tree, std::ostream& out)
+        : tree_{tree}, writer_{out} {}
+
+    void add(key_type key)
+    {
+        writer_.write(Op::add, key);
+        tree_.add(key);
+    }
+
+    std::optional<key_type> search(key_type key)
+    {
+        writer_.write(Op::search, key);
+        return tree_.search(key);
+    }
+
+    bool remove(key_type key)
+    {
+        writer_.write(Op::remove, key);
+        return tree_.remove(key);
+    }
+
+    std::optional<key_type> extract_min()
+    {
+        writer_.write(Op::extract_min);
+        return tree_.extract_min();
+    }
+
+    std::optional<key_type> extract_max()
+    {
+        writer_.write(Op::extract_max);
+        return tree_.extract_max();
+    }
+
+    Tree& tree() { return tree_; }
+
+};
+
+}  // namespace tree
@@ -17,6 +17,8 @@ struct My_Data
     }
     My_Data(My_Data&& other)
         : key{other.key}, name{std::move(other.name)} {}
+    My_Data& operator=(const My_Data& other) = default;
+    My_Data& operator=(My_Data&& other) = default;
     ~My_Data() {}
 
     auto operator<=>(const My_Data& other) const
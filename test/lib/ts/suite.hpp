@@ -5,6 +5,11 @@
 #include <vector>
 #include <string>
 #include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <iomanip>
 
 
 namespace ts
@@ -16,6 +21,30 @@ constexpr std::string GREEN { "\033[32m" };
 constexpr std::string CYAN  { "\033[36m" };
 constexpr std::string RESET { "\033[0m"  };
 
+// Human readable duration.
+inline std::string format_ns(double ns)
+{
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    if      ( ns >= 1e9 ) oss << ns / 1e9 << " s";
+    else if ( ns >= 1e6 ) oss << ns / 1e6 << " ms";
+    else if ( ns >= 1e3 ) oss << ns / 1e3 << " us";
+    else                  oss << ns << " ns";
+    return oss.str();
+}
+
+// Outcome of one test or benchmark.
+struct Result
+{
+    std::string suite;
+    std::string message;
+    bool passed { false };
+    double ns { 0 };            // Duration of a test, or median of a benchmark.
+    double min_ns { 0 };        // Benchmarks only.
+    double stddev_ns { 0 };     // Benchmarks only.
+    size_t repetitions { 1 };
+};
+
 
 class Suite
 {
@@ -25,45 +54,99 @@ public:
 
 private:
 
+    struct Entry
+    {
+        std::string message;
+        test_function_t test;
+        size_t repetitions { 0 };   // 0 for plain tests, number of timed runs for benchmarks.
+    };
+
     std::string name_;
-    std::vector<std::pair<std::string, test_function_t>> tests_;
+    std::vector<Entry> tests_;
+    std::vector<Result> results_;
+
+    static double elapsed_ns_(const test_function_t& test)
+    {
+        auto start { std::chrono::steady_clock::now() };
+        test();
+        auto stop { std::chrono::steady_clock::now() };
+        return std::chrono::duration<double, std::nano>(stop - start).count();
+    }
+
+    // Warm up, then time every repetition on its own.
+    static void bench_(const Entry& entry, Result& result)
+    {
+        size_t warm_up { std::max<size_t>(1, entry.repetitions / 10) };
+        for ( size_t i {0}; i < warm_up; ++i ) entry.test();
+        std::vector<double> samples;
+        samples.reserve(entry.repetitions);
+        for ( size_t i {0}; i < entry.repetitions; ++i ) samples.push_back(elapsed_ns_(entry.test));
+        std::sort(samples.begin(), samples.end());
+        size_t n { samples.size() };
+        double mean { std::accumulate(samples.begin(), samples.end(), 0.0) / n };
+        double variance { 0 };
+        for ( double sample : samples ) variance += (sample - mean) * (sample - mean);
+        result.min_ns = samples.front();
+        result.ns = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+        result.stddev_ns = std::sqrt(variance / n);
+        result.repetitions = n;
+    }
 
 public:
 
     Suite(const std::string& name = "Test Suite")   // TO DO check why const &
         : name_{name} {}
 
+    const std::string& name() const { return name_; }
+    const std::vector<Result>& results() const { return results_; }
+
     void register_test(const std::string& message, test_function_t test)
     {
-        tests_.emplace_back(message, test);
+        tests_.push_back(Entry{ message, test });
     }
 
-    void run()
+    void register_bench(const std::string& message, test_function_t test, size_t repetitions)
+    {
+        tests_.push_back(Entry{ message, test, std::max<size_t>(1, repetitions) });
+    }
+
+    void run(std::ostream& out = std::cout)
     {
         int passed { 0 };
         int failed { 0 };
-        std::cout << "Running tests from " << CYAN << name_ << RESET <<'\n';
-        for ( const auto& [message, test] : tests_ )
+        results_.clear();
+        out << "Running tests from " << CYAN << name_ << RESET <<'\n';
+        for ( const auto& entry : tests_ )
         {
+            Result result { name_, entry.message };
+            const std::string& message { entry.message };
             try
             {
-                test();
-                std::cout << GREEN << "[PASSED] " << RESET << message << '\n';
+                if ( entry.repetitions ) bench_(entry, result);
+                else                     result.ns = elapsed_ns_(entry.test);
+                result.passed = true;
+                if ( entry.repetitions )
+                    out << GREEN << "[BENCH]  " << RESET << message
+                        << " (min " << format_ns(result.min_ns) << ", median " << format_ns(result.ns)
+                        << ", stddev " << format_ns(result.stddev_ns) << ", " << result.repetitions << " runs)\n";
+                else
+                    out << GREEN << "[PASSED] " << RESET << message << " (" << format_ns(result.ns) << ")\n";
                 ++passed;
             }
             catch(const std::exception& e)
             {
-                std::cout << RED << "[FAILED] " << RESET << message << e.what() << '\n';
+                out << RED << "[FAILED] " << RESET << message << e.what() << '\n';
                 ++failed;
             }
             catch(...)
             {
-                std::cout << "[FAILED] " << message << ": unknown error\n";
+                out << "[FAILED] " << message << ": unknown error\n";
                 ++failed;
             }
+            results_.push_back(result);
         }
-        std::cout << "Suite Summary: " << passed << " passed, " << failed << " failed.\n";
-        std::cout << "==================================\n\n";
+        out << "Suite Summary: " << passed << " passed, " << failed << " failed.\n";
+        out << "==================================\n\n";
     }
 
 };
@@ -84,6 +167,21 @@ public:
     } NAME(test_registrar_);                                   \
     void NAME(TestFunction_)()
 
+/*
+    Benchmark: body runs repetitions times after a short warm-up, every run is
+    timed on its own and the suite reports minimum, median and standard deviation.
+*/
+#define BENCH(suite, message, repetitions)                                   \
+    void NAME(BenchFunction_)();                                             \
+    struct NAME(BenchRegistrar_)                                             \
+    {                                                                        \
+        NAME(BenchRegistrar_)()                                              \
+        {                                                                    \
+            suite.register_bench(message, NAME(BenchFunction_), repetitions); \
+        }                                                                    \
+    } NAME(bench_registrar_);                                                \
+    void NAME(BenchFunction_)()
+
 #define ASSERT_TRUE(condition)                                        \
 if ( !(condition) )                                                   \
 {                                                                     \
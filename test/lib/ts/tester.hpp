@@ -2,6 +2,12 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
 
 #include "suite.hpp"
 
@@ -25,12 +31,55 @@ public:
         suites_.insert(std::make_pair(name, suite));
     }
 
-    void run()
+    /*
+        Run all suites. With more than one thread, suites run in parallel and
+        output of every suite is printed in one piece once all of them finish.
+    */
+    void run(size_t threads = 1)
     {
         std::cout << name_ << "\n\n";
-        for ( auto [name, suite] : suites_ )
+        if ( threads <= 1 )
         {
-            suite.run();
+            for ( auto& [name, suite] : suites_ )
+            {
+                suite.run();
+            }
+            return;
+        }
+
+        std::vector<Suite*> suites;
+        for ( auto& [name, suite] : suites_ ) suites.push_back(&suite);
+        std::vector<std::ostringstream> outputs(suites.size());
+        std::atomic<size_t> next { 0 };
+        {
+            std::vector<std::jthread> workers;
+            for ( size_t i {0}; i < std::min(threads, suites.size()); ++i )
+            {
+                workers.emplace_back([&]()
+                {
+                    for ( size_t j { next++ }; j < suites.size(); j = next++ )
+                        suites[j]->run(outputs[j]);
+                });
+            }
+        }
+        for ( const auto& output : outputs ) std::cout << output.str();
+    }
+
+    // Write results of the last run as CSV: suite,test,status,ns,min_ns,stddev_ns,repetitions
+    void write(const std::string& path) const
+    {
+        std::ofstream out { path };
+        out << "suite,test,status,ns,min_ns,stddev_ns,repetitions\n";
+        for ( const auto& [name, suite] : suites_ )
+        {
+            for ( const auto& result : suite.results() )
+            {
+                std::string message { result.message };
+                std::replace(message.begin(), message.end(), ',', ';');
+                out << name << ',' << message << ',' << (result.passed ? "passed" : "failed") << ','
+                    << result.ns << ',' << result.min_ns << ',' << result.stddev_ns << ','
+                    << result.repetitions << '\n';
+            }
         }
     }
 
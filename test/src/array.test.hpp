@@ -0,0 +1,65 @@
+/*
+    Test of read-only search tree in Eytzinger layout
+*/
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include "..\lib\ts\suite.hpp"
+#include "..\..\include\array.hpp"
+#include "..\..\include\avl.hpp"
+
+
+ts::Suite tests_array { "Eytzinger layout" };
+
+TEST(tests_array, "Empty tree contains nothing.")
+{
+    tree::Eytzinger<int> array_tree;
+    ASSERT_TRUE( array_tree.empty() )
+    ASSERT_FALSE( array_tree.contains(7) )
+    ASSERT_FALSE( array_tree.lower_bound(7).has_value() )
+}
+
+TEST(tests_array, "Lower bound matches std::lower_bound.")
+{
+    std::vector<int> sorted;
+    for ( int i {0}; i < 1000; ++i ) sorted.push_back(3 * i);
+    tree::Eytzinger<int> array_tree { sorted };
+    for ( int key {-2}; key < 3002; ++key )
+    {
+        auto expected { std::lower_bound(sorted.begin(), sorted.end(), key) };
+        auto result { array_tree.lower_bound(key) };
+        ASSERT_EQ( result.has_value(), (expected != sorted.end()) )
+        if ( result ) ASSERT_EQ( result.value(), *expected )
+        ASSERT_EQ( array_tree.contains(key), (expected != sorted.end() && *expected == key) )
+    }
+}
+
+TEST(tests_array, "Build from AVL.")
+{
+    tree::AVL<int> search_tree { std::vector<int>({7, 2, 56, 8, 23, 3}) };
+    tree::Eytzinger<int> array_tree { search_tree };
+    ASSERT_EQ( array_tree.size(), 6 )
+    ASSERT_EQ( array_tree.data()[0], 8 )   // Root of complete tree with 6 nodes.
+    ASSERT_TRUE( array_tree.contains(56) )
+    ASSERT_EQ( array_tree.lower_bound(9).value(), 23 )
+}
+
+TEST(tests_array, "Floor, predecessor, successor and nearest.")
+{
+    std::vector<int> sorted;
+    for ( int i {0}; i < 100; ++i ) sorted.push_back(3 * i);
+    tree::Eytzinger<int> array_tree { sorted };
+    for ( int key {-2}; key < 302; ++key )
+    {
+        auto upper { std::upper_bound(sorted.begin(), sorted.end(), key) };
+        auto lower { std::lower_bound(sorted.begin(), sorted.end(), key) };
+        ASSERT_TRUE( (array_tree.successor(key) == (upper == sorted.end() ? std::nullopt : std::optional<int>(*upper))) )
+        ASSERT_TRUE( (array_tree.floor(key) == (upper == sorted.begin() ? std::nullopt : std::optional<int>(*(upper - 1)))) )
+        ASSERT_TRUE( (array_tree.predecessor(key) == (lower == sorted.begin() ? std::nullopt : std::optional<int>(*(lower - 1)))) )
+    }
+    ASSERT_EQ( *array_tree.nearest(4), 3 )
+    ASSERT_EQ( *array_tree.nearest(5), 6 )
+    ASSERT_EQ( *array_tree.nearest(1000), 297 )
+}
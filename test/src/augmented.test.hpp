@@ -0,0 +1,87 @@
+/*
+    Test of AVL with subtree summaries
+*/
+#pragma once
+
+#include <random>
+#include <set>
+#include <vector>
+
+#include "..\lib\ts\suite.hpp"
+#include "..\..\include\augmented.hpp"
+
+
+ts::Suite tests_augmented { "Augmented AVL" };
+
+using Sum_Tree_ = tree::AugmentedAVL<int, tree::SumOf<long long>>;
+
+// Check summaries of all subtrees, return sum of the subtree.
+long long check_sums_(const std::unique_ptr<tree::Node<Sum_Tree_::value_type>>& node, bool& valid)
+{
+    if ( !node ) return 0;
+    long long sum { check_sums_(node->left(), valid) + node->data.value + check_sums_(node->right(), valid) };
+    valid = valid && sum == node->data.summary;
+    return sum;
+}
+
+bool summaries_hold_(Sum_Tree_& search_tree)
+{
+    bool valid { true };
+    check_sums_(search_tree.tree().root(), valid);
+    return valid;
+}
+
+TEST(tests_augmented, "Range sums agree with a scan.")
+{
+    std::mt19937 generator { 40 };
+    std::uniform_int_distribution<int> distribution { 0, 999 };
+    Sum_Tree_ search_tree;
+    std::multiset<int> reference;
+    for ( int i {0}; i < 2000; ++i )
+    {
+        int key { distribution(generator) };
+        search_tree.add(key);
+        reference.insert(key);
+    }
+    for ( int i {0}; i < 500; ++i )
+    {
+        int key { distribution(generator) };
+        auto it { reference.find(key) };
+        ASSERT_EQ( search_tree.remove(key), (it != reference.end()) )
+        if ( it != reference.end() ) reference.erase(it);
+    }
+    ASSERT_TRUE( summaries_hold_(search_tree) )
+    ASSERT_TRUE( tree::is_balanced(search_tree.tree().root()) )
+    for ( int i {0}; i < 100; ++i )
+    {
+        int lo { distribution(generator) };
+        int hi { lo + distribution(generator) / 4 };
+        long long expected { 0 };
+        for ( auto it { reference.lower_bound(lo) }; it != reference.end() && *it <= hi; ++it ) expected += *it;
+        ASSERT_EQ( search_tree.aggregate(lo, hi), expected )
+    }
+}
+
+TEST(tests_augmented, "Min, max and count over ranges.")
+{
+    std::vector<int> keys;
+    for ( int key {0}; key < 100; ++key ) keys.push_back(key * 3);
+    tree::AugmentedAVL<int, tree::MinOf<int>> minimum { keys };
+    tree::AugmentedAVL<int, tree::MaxOf<int>> maximum { keys };
+    tree::AugmentedAVL<int, tree::CountOf<int>> count { keys };
+    ASSERT_EQ( *minimum.aggregate(10, 100), 12 )
+    ASSERT_EQ( *maximum.aggregate(10, 100), 99 )
+    ASSERT_EQ( count.aggregate(10, 100), 30 )
+    ASSERT_FALSE( minimum.aggregate(1, 2).has_value() )
+    ASSERT_EQ( count.aggregate(), 100 )
+    ASSERT_EQ( count.aggregate(300, 400), 0 )
+}
+
+TEST(tests_augmented, "Appends keep summaries up to the root.")
+{
+    Sum_Tree_ search_tree;
+    for ( int key {1}; key <= 1000; ++key ) search_tree.add(key);
+    ASSERT_EQ( search_tree.aggregate(), 500500 )
+    ASSERT_EQ( search_tree.aggregate(1, 10), 55 )
+    ASSERT_TRUE( summaries_hold_(search_tree) )
+}
@@ -179,3 +179,130 @@ TEST(tests_AVL, "Extracting minimum node preserves balance.")
     search_tree.extract_min_node();
     ASSERT_TRUE( tree::is_balanced(search_tree.root()) )
 }
+
+/*
+    Parent links and cursor
+*/
+bool parent_links_(const std::unique_ptr<tree::Node<int>>& node)
+{
+    if ( !node ) return true;
+    if ( node->left()  && node->left()->parent()  != node.get() ) return false;
+    if ( node->right() && node->right()->parent() != node.get() ) return false;
+    return parent_links_(node->left()) && parent_links_(node->right());
+}
+
+TEST(tests_AVL, "Rotations and removals keep parent links.")
+{
+    std::mt19937 generator { 34 };
+    std::uniform_int_distribution<int> distribution { 0, 999 };
+    tree::AVL<int> search_tree;
+    for ( int i {0}; i < 2000; ++i ) search_tree.add(distribution(generator));
+    for ( int i {0}; i < 1000; ++i ) search_tree.remove(distribution(generator));
+    search_tree.extract_min();
+    search_tree.extract_max();
+    ASSERT_TRUE( parent_links_(search_tree.root()) )
+    ASSERT_TRUE( (search_tree.root()->parent() == nullptr) )
+}
+
+TEST(tests_AVL, "Cursor walks keys in both directions.")
+{
+    tree::AVL<int> search_tree;
+    for ( int key {0}; key < 100; ++key ) search_tree.add(key);
+    auto cursor { search_tree.cursor() };
+    while ( cursor.get()->left() ) cursor.left();
+    int expected { 0 };
+    for ( ; cursor; cursor.next() ) ASSERT_EQ( *cursor, expected++ )
+    ASSERT_EQ( expected, 100 )
+    cursor = tree::Cursor<int>(tree::Cursor<int>::last(search_tree.root().get()));
+    for ( ; cursor; cursor.prev() ) ASSERT_EQ( *cursor, --expected )
+    ASSERT_EQ( expected, 0 )
+}
+
+TEST(tests_AVL, "Cursor climbs back to the root.")
+{
+    tree::AVL<int> search_tree;
+    for ( int key {0}; key < 100; ++key ) search_tree.add(key);
+    auto cursor { search_tree.cursor() };
+    cursor.right().left().right();
+    ASSERT_TRUE( (cursor.parent().parent().parent() == search_tree.cursor()) )
+    ASSERT_FALSE( cursor.parent() )
+}
+
+TEST(tests_AVL, "Copy of iterator continues independently.")
+{
+    tree::AVL<int> search_tree;
+    for ( int key {0}; key < 10; ++key ) search_tree.add(key);
+    auto it { search_tree.begin() };
+    ++it;
+    auto copy { it };
+    ++it;
+    ASSERT_EQ( *copy, 1 )
+    ASSERT_EQ( *it, 2 )
+}
+
+/*
+    Appends and insertion with hint
+*/
+TEST(tests_AVL, "Monotonic appends keep the tree balanced.")
+{
+    tree::AVL<int, tree::CountingStats> search_tree;
+    for ( int key {0}; key < 10000; ++key ) search_tree.add(key);
+    for ( int key {0}; key > -10000; --key ) search_tree.add(key);
+    ASSERT_TRUE( tree::is_balanced(search_tree.root()) )
+    ASSERT_TRUE( parent_links_(search_tree.root()) )
+    ASSERT_TRUE( (search_tree.stats().comparisons < 2 * 20000) )
+}
+
+TEST(tests_AVL, "Appends after removal find the ends again.")
+{
+    tree::AVL<int> search_tree;
+    for ( int key {0}; key < 100; ++key ) search_tree.add(key);
+    search_tree.extract_max();
+    search_tree.remove(0);
+    search_tree.add(200);
+    search_tree.add(-5);
+    ASSERT_EQ( *search_tree.max(), 200 )
+    ASSERT_EQ( *search_tree.min(), -5 )
+    ASSERT_TRUE( tree::is_balanced(search_tree.root()) )
+}
+
+TEST(tests_AVL, "Insertion with hint keeps order and balance.")
+{
+    tree::AVL<int> search_tree;
+    for ( int key {0}; key < 1000; key += 2 ) search_tree.add(key);
+    auto hint { search_tree.begin() };
+    ++hint;                                             // At 2.
+    auto it { search_tree.insert_hint(hint, 1) };       // Right hint.
+    ASSERT_EQ( *it, 1 )
+    it = search_tree.insert_hint(search_tree.end(), 999);
+    ASSERT_EQ( *it, 999 )
+    it = search_tree.insert_hint(search_tree.begin(), 501);   // Wrong hint.
+    ASSERT_EQ( *it, 501 )
+    ++it;
+    ASSERT_EQ( *it, 502 )
+    for ( int key {3}; key < 999; key += 2 )
+        if ( key != 501 ) search_tree.insert_hint(search_tree.end(), key);
+    ASSERT_TRUE( tree::is_balanced(search_tree.root()) )
+    ASSERT_TRUE( parent_links_(search_tree.root()) )
+    int expected { 0 };
+    for ( int key : search_tree ) ASSERT_EQ( key, expected++ )
+    ASSERT_EQ( expected, 1000 )
+}
+
+/*
+    Benchmarks
+*/
+BENCH(tests_AVL, "Adding 10000 sorted keys.", 20)
+{
+    tree::AVL<int> search_tree;
+    for ( int key {0}; key < 10000; ++key ) search_tree.add(key);
+}
+
+BENCH(tests_AVL, "Removing 10000 keys.", 20)
+{
+    tree::AVL<int> search_tree;
+    for ( int key {0}; key < 10000; ++key ) search_tree.add(key);
+    for ( int key {0}; key < 10000; key += 2 ) search_tree.remove(key);
+    for ( int key {1}; key < 10000; key += 2 ) search_tree.remove(key);
+    ASSERT_FALSE( search_tree.root() )
+}
@@ -4,6 +4,10 @@
 #pragma once
 
 #include <algorithm>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
 
 #include "..\lib\ts\suite.hpp"
 #include "..\..\include\bst.hpp"
@@ -255,3 +259,130 @@ TEST(tests_BST, "Extracted minimum node from empty tree is nullptr.")
     tree::BST<int> search_tree;
     ASSERT_FALSE( search_tree.extract_min_node() )
 }
+
+/*
+    Benchmarks
+*/
+std::vector<int> generate_bst_keys_(int count)
+{
+    std::vector<int> keys(count);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937{42});
+    return keys;
+}
+
+BENCH(tests_BST, "Adding 10000 random keys.", 20)
+{
+    static const auto keys { generate_bst_keys_(10000) };
+    tree::BST<int> search_tree;
+    for ( int key : keys ) search_tree.add(key);
+}
+
+BENCH(tests_BST, "Searching 10000 random keys.", 20)
+{
+    static const auto keys { generate_bst_keys_(10000) };
+    static tree::BST<int> search_tree { keys };
+    size_t found { 0 };
+    for ( int key : keys ) found += search_tree.search(key).has_value();
+    ASSERT_EQ( found, keys.size() )
+}
+
+TEST(tests_BST, "Releasing tree asynchronously empties it.")
+{
+    tree::BST<int> search_tree { generate_bst_keys_(10000) };
+    search_tree.release_async();
+    ASSERT_FALSE( search_tree.root() )
+    search_tree.add(7);
+    ASSERT_TRUE( search_tree.search(7).has_value() )
+    tree::Reclaimer::instance().drain();
+}
+
+/*
+    Batched search
+*/
+TEST(tests_BST, "Batched search agrees with single searches.")
+{
+    tree::BST<int> search_tree { generate_bst_keys_(1000) };
+    std::vector<int> keys(100);
+    std::mt19937 generator { 36 };
+    std::uniform_int_distribution<int> distribution { -500, 1500 };
+    for ( int& key : keys ) key = distribution(generator);
+    std::vector<std::optional<int>> found(keys.size());
+    search_tree.search_batch(keys, found);
+    for ( size_t i {0}; i < keys.size(); ++i )
+        ASSERT_TRUE( (found[i] == search_tree.search(keys[i])) )
+}
+
+TEST(tests_BST, "Batched search of empty tree finds nothing.")
+{
+    tree::BST<int> search_tree;
+    std::vector<int> keys { 1, 2, 3 };
+    std::vector<std::optional<int>> found(keys.size(), 0);
+    search_tree.search_batch(keys, found);
+    ASSERT_TRUE( std::none_of(found.begin(), found.end(), [](const auto& key){ return key.has_value(); }) )
+}
+
+/*
+    Search with sorted probes
+*/
+TEST(tests_BST, "Sorted search agrees with single searches.")
+{
+    tree::BST<int> search_tree { generate_bst_keys_(1000) };
+    std::vector<int> keys(300);
+    std::mt19937 generator { 37 };
+    std::uniform_int_distribution<int> distribution { -100, 1100 };
+    for ( int& key : keys ) key = distribution(generator);
+    std::sort(keys.begin(), keys.end());
+    auto found { search_tree.search_sorted(keys) };
+    ASSERT_EQ( found.size(), keys.size() )
+    for ( size_t i {0}; i < keys.size(); ++i )
+        ASSERT_TRUE( (found[i] == search_tree.search(keys[i])) )
+}
+
+TEST(tests_BST, "Sorted search compares less than single searches.")
+{
+    tree::BST<int, tree::CountingStats> search_tree { generate_bst_keys_(10000) };
+    std::vector<int> keys(1000);
+    std::iota(keys.begin(), keys.end(), 5000);
+    for ( int key : keys ) search_tree.search(key);
+    auto single { search_tree.stats().comparisons };
+    search_tree.reset_stats();
+    ASSERT_EQ( search_tree.intersect_keys(keys).size(), keys.size() )
+    ASSERT_TRUE( (search_tree.stats().comparisons < single) )
+}
+
+TEST(tests_BST, "Intersection with unsorted keys is still correct.")
+{
+    tree::BST<int> search_tree { std::vector<int>({5, 3, 8, 1, 4, 7, 9}) };
+    auto keys { search_tree.intersect_keys(std::vector<int>({9, 2, 4, 4, 10, 1})) };
+    ASSERT_TRUE( (keys == std::vector<int>({9, 4, 4, 1})) )
+}
+
+/*
+    Nearest keys
+*/
+TEST(tests_BST, "Floor, ceiling, predecessor, successor and nearest agree with std::set.")
+{
+    std::vector<int> keys;
+    for ( int key : generate_bst_keys_(500) ) keys.push_back(4 * key);
+    tree::BST<int> search_tree { keys };
+    std::set<int> reference(keys.begin(), keys.end());
+    auto value = [&](auto it){ return it == reference.end() ? std::optional<int>() : std::optional<int>(*it); };
+    for ( int key {-3}; key < 2003; ++key )
+    {
+        auto ceiling { reference.lower_bound(key) };
+        auto successor { reference.upper_bound(key) };
+        auto floor { successor == reference.begin() ? reference.end() : std::prev(successor) };
+        auto predecessor { ceiling == reference.begin() ? reference.end() : std::prev(ceiling) };
+        ASSERT_TRUE( (search_tree.ceiling(key) == value(ceiling)) )
+        ASSERT_TRUE( (search_tree.successor(key) == value(successor)) )
+        ASSERT_TRUE( (search_tree.floor(key) == value(floor)) )
+        ASSERT_TRUE( (search_tree.predecessor(key) == value(predecessor)) )
+    }
+    ASSERT_EQ( *search_tree.nearest(9), 8 )
+    ASSERT_EQ( *search_tree.nearest(10), 8 )      // Tie goes to the smaller key.
+    ASSERT_EQ( *search_tree.nearest(11), 12 )
+    ASSERT_EQ( *search_tree.nearest(-100), 0 )
+    ASSERT_EQ( *search_tree.nearest(5000), 1996 )
+    ASSERT_FALSE( tree::BST<int>().nearest(1).has_value() )
+}
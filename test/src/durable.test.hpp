@@ -0,0 +1,133 @@
+/*
+    Test of write-ahead log and snapshots
+*/
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "..\lib\ts\suite.hpp"
+#include "..\..\include\avl.hpp"
+#include "..\..\include\durable.hpp"
+
+
+ts::Suite tests_durable { "Write-ahead log and snapshots" };
+
+// Fresh path in the temporary directory, without files.
+inline std::filesystem::path durable_path_(const std::string& name)
+{
+    std::filesystem::path path { std::filesystem::temp_directory_path() / ("tree_durable_" + name) };
+    for ( const auto& entry : std::filesystem::directory_iterator(path.parent_path()) )
+        if ( entry.path().filename().string().starts_with(path.filename().string() + ".") )
+            std::filesystem::remove(entry.path());
+    return path;
+}
+
+inline std::vector<int> durable_keys_(tree::AVL<int>& search_tree)
+{
+    return std::vector<int>(search_tree.begin(), search_tree.end());
+}
+
+TEST(tests_durable, "Committed operations survive a restart.")
+{
+    auto path { durable_path_("restart") };
+    {
+        tree::AVL<int> search_tree;
+        tree::Durable durable { search_tree, path, 4 };
+        for ( int key {0}; key < 10; ++key ) durable.add(key);
+        ASSERT_TRUE( durable.remove(3) )
+        ASSERT_FALSE( durable.remove(30) )
+        ASSERT_EQ( durable.extract_max().value(), 9 )
+    }
+    tree::AVL<int> recovered;
+    tree::Durable durable { recovered, path };
+    ASSERT_TRUE( (durable_keys_(recovered) == std::vector<int>({0, 1, 2, 4, 5, 6, 7, 8})) )
+    ASSERT_EQ( durable.generation(), 2 )
+    ASSERT_EQ( std::filesystem::file_size(path.string() + ".2.wal"), 5 )
+    ASSERT_FALSE( std::filesystem::exists(path.string() + ".1.wal") )
+}
+
+TEST(tests_durable, "Recovery loads the snapshot and replays the log after it.")
+{
+    auto path { durable_path_("snapshot") };
+    {
+        tree::AVL<int> search_tree;
+        tree::Durable durable { search_tree, path };
+        for ( int key {0}; key < 1000; ++key ) durable.add(key);
+        durable.checkpoint();
+        for ( int key {0}; key < 1000; key += 2 ) durable.remove(key);
+        durable.add(5000);
+    }
+    tree::AVL<int> recovered;
+    tree::Durable durable { recovered, path };
+    auto keys { durable_keys_(recovered) };
+    ASSERT_EQ( keys.size(), 501 )
+    ASSERT_EQ( keys.front(), 1 )
+    ASSERT_EQ( keys.back(), 5000 )
+    ASSERT_TRUE( tree::height(recovered.root()) <= 14 )
+    // Heights came back with the snapshot, so adding keeps the tree balanced.
+    for ( int key {5001}; key < 6000; ++key ) durable.add(key);
+    ASSERT_TRUE( tree::height(recovered.root()) <= 16 )
+}
+
+TEST(tests_durable, "Uncommitted records are lost, a torn record ends replay.")
+{
+    auto path { durable_path_("torn") };
+    {
+        tree::AVL<int> search_tree;
+        tree::Durable durable { search_tree, path, 1000 };
+        durable.add(1);
+        durable.add(2);
+        durable.commit();
+        durable.add(3);
+        ASSERT_EQ( durable.pending(), 1 )
+        // Crash: the pending record never reaches the file, the last one is cut short.
+        std::ofstream log { path.string() + ".1.wal", std::ios::binary | std::ios::app };
+        log.put(0);
+        log.put(static_cast<char>(0x80));
+        log.close();
+        std::filesystem::copy_file(path.string() + ".1.wal", path.string() + ".crash");
+    }
+    std::filesystem::rename(path.string() + ".crash", path.string() + ".1.wal");
+    tree::AVL<int> recovered;
+    tree::Durable durable { recovered, path };
+    ASSERT_TRUE( (durable_keys_(recovered) == std::vector<int>({1, 2})) )
+}
+
+TEST(tests_durable, "Crash between snapshot and new log doesn't replay the old log.")
+{
+    auto path { durable_path_("checkpoint") };
+    {
+        tree::AVL<int> search_tree;
+        tree::Durable durable { search_tree, path };
+        durable.add(1);
+        durable.add(2);
+        durable.commit();
+        std::filesystem::copy_file(path.string() + ".1.wal", path.string() + ".crash");
+        durable.checkpoint();
+    }
+    // Old log left behind, new one not created yet.
+    std::filesystem::remove(path.string() + ".2.wal");
+    std::filesystem::rename(path.string() + ".crash", path.string() + ".1.wal");
+    tree::AVL<int> recovered;
+    tree::Durable durable { recovered, path };
+    ASSERT_TRUE( (durable_keys_(recovered) == std::vector<int>({1, 2})) )
+    ASSERT_FALSE( std::filesystem::exists(path.string() + ".1.wal") )
+}
+
+TEST(tests_durable, "Snapshot keeps 64-bit keys.")
+{
+    auto path { durable_path_("wide") };
+    {
+        tree::AVL<long long> search_tree;
+        tree::Durable durable { search_tree, path };
+        durable.add(5'000'000'000);
+        durable.add(-5'000'000'000);
+        durable.add(7);
+        durable.checkpoint();
+    }
+    tree::AVL<long long> recovered;
+    tree::Durable durable { recovered, path };
+    ASSERT_TRUE( (std::vector<long long>(recovered.begin(), recovered.end()) == std::vector<long long>({-5'000'000'000, 7, 5'000'000'000})) )
+}
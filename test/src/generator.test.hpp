@@ -0,0 +1,88 @@
+/*
+    Test of lazy traversals and of traversals stopped by the callback
+*/
+#pragma once
+
+#include <ranges>
+#include <vector>
+
+#include "..\lib\ts\suite.hpp"
+#include "..\..\include\avl.hpp"
+
+
+ts::Suite tests_generator { "Lazy traversals" };
+
+/*
+            4
+         /     \
+        2       6
+       / \     / \
+      1   3   5   7
+*/
+tree::AVL<int> set_up_generator_tree_()
+{
+    return tree::AVL<int> { std::vector<int>({1, 2, 3, 4, 5, 6, 7}) };
+}
+
+template<typename R>
+std::vector<int> collect_(R&& range)
+{
+    std::vector<int> keys;
+    for ( int key : range ) keys.push_back(key);
+    return keys;
+}
+
+TEST(tests_generator, "Generators visit nodes in the same order as callbacks.")
+{
+    auto search_tree { set_up_generator_tree_() };
+    std::vector<int> expected;
+    auto push = [&](int key){ expected.push_back(key); };
+
+    tree::in_order(search_tree, push);
+    ASSERT_TRUE( (collect_(tree::in_order(search_tree)) == expected) )
+    expected.clear();
+    tree::pre_order(search_tree, push);
+    ASSERT_TRUE( (collect_(tree::pre_order(search_tree)) == expected) )
+    expected.clear();
+    tree::post_order(search_tree, push);
+    ASSERT_TRUE( (collect_(tree::post_order(search_tree)) == expected) )
+    expected.clear();
+    tree::level_order(search_tree, push);
+    ASSERT_TRUE( (collect_(tree::level_order(search_tree)) == expected) )
+    ASSERT_TRUE( (expected == std::vector<int>({4, 2, 6, 1, 3, 5, 7})) )
+}
+
+TEST(tests_generator, "Generators compose with ranges views.")
+{
+    tree::AVL<int> search_tree;
+    for ( int key {0}; key < 1000; ++key ) search_tree.add(key);
+    auto odd = [](int key){ return key % 2 == 1; };
+    auto keys { collect_(tree::in_order(search_tree) | std::views::filter(odd) | std::views::take(3)) };
+    ASSERT_TRUE( (keys == std::vector<int>({1, 3, 5})) )
+}
+
+TEST(tests_generator, "Generator of an empty tree is empty.")
+{
+    tree::BST<int> search_tree;
+    ASSERT_TRUE( collect_(tree::post_order(search_tree)).empty() )
+    ASSERT_TRUE( collect_(tree::level_order(search_tree)).empty() )
+}
+
+TEST(tests_generator, "Callback returning stop ends traversal.")
+{
+    auto search_tree { set_up_generator_tree_() };
+    std::vector<int> keys;
+    auto first_three = [&](int key)
+    {
+        keys.push_back(key);
+        return keys.size() < 3 ? tree::Visit::proceed : tree::Visit::stop;
+    };
+    tree::in_order(search_tree, first_three);
+    ASSERT_TRUE( (keys == std::vector<int>({1, 2, 3})) )
+    keys.clear();
+    tree::level_order(search_tree, first_three);
+    ASSERT_TRUE( (keys == std::vector<int>({4, 2, 6})) )
+    keys.clear();
+    tree::post_order(search_tree, first_three);
+    ASSERT_TRUE( (keys == std::vector<int>({1, 3, 2})) )
+}
@@ -0,0 +1,81 @@
+/*
+    Test of Huffman coding
+*/
+#pragma once
+
+#include <sstream>
+#include <string>
+#include <random>
+
+#include "..\lib\ts\suite.hpp"
+#include "..\..\include\huffman.hpp"
+
+
+ts::Suite tests_huffman { "Huffman coding" };
+
+std::string huffman_round_trip_(const std::string& text, size_t block_size = tree::huffman::BLOCK_SIZE)
+{
+    std::istringstream in { text };
+    std::stringstream compressed;
+    tree::huffman::compress(in, compressed, block_size);
+    std::ostringstream out;
+    tree::huffman::decompress(compressed, out);
+    return out.str();
+}
+
+TEST(tests_huffman, "Tree of four symbols.")
+{
+    std::string text { "aaaaaaaabbbbccd" };
+    auto freq { tree::huffman::count_frequencies(reinterpret_cast<const std::uint8_t*>(text.data()), text.size()) };
+    auto root { tree::huffman::build_tree(freq) };
+    ASSERT_EQ( root->data.weight, 15 )
+    ASSERT_EQ( tree::count_nodes(root), 7 )
+    auto lengths { tree::huffman::code_lengths(root, freq) };
+    ASSERT_EQ( lengths['a'], 1 )
+    ASSERT_EQ( lengths['b'], 2 )
+    ASSERT_EQ( lengths['c'], 3 )
+    ASSERT_EQ( lengths['d'], 3 )
+}
+
+TEST(tests_huffman, "Canonical codes are prefix free and ordered.")
+{
+    tree::huffman::Lengths lengths {};
+    lengths['a'] = 1; lengths['b'] = 2; lengths['c'] = 3; lengths['d'] = 3;
+    auto codes { tree::huffman::canonical_codes(lengths) };
+    ASSERT_EQ( codes['a'].bits, 0b0 )
+    ASSERT_EQ( codes['b'].bits, 0b10 )
+    ASSERT_EQ( codes['c'].bits, 0b110 )
+    ASSERT_EQ( codes['d'].bits, 0b111 )
+}
+
+TEST(tests_huffman, "Code lengths are limited.")
+{
+    tree::huffman::Frequencies freq {};
+    std::uint64_t weight { 1 };
+    for ( int s {0}; s < 40; ++s, weight += weight / 2 + 1 ) freq[s] = weight;  // Skewed, deep tree.
+    auto lengths { tree::huffman::code_lengths(tree::huffman::build_tree(freq), freq) };
+    std::uint64_t kraft { 0 };
+    for ( int s {0}; s < 40; ++s )
+    {
+        ASSERT_TRUE( lengths[s] >= 1 && lengths[s] <= tree::huffman::MAX_BITS )
+        kraft += std::uint64_t{1} << (tree::huffman::MAX_BITS - lengths[s]);
+    }
+    ASSERT_TRUE( kraft <= (std::uint64_t{1} << tree::huffman::MAX_BITS) )
+}
+
+TEST(tests_huffman, "Round trip of empty, single symbol and text input.")
+{
+    ASSERT_EQ( huffman_round_trip_(""), "" )
+    ASSERT_EQ( huffman_round_trip_("zzzzzzzz"), "zzzzzzzz" )
+    std::string text { "1 2 4 # # 5 6 # # 7 # # 3 # # " };
+    ASSERT_EQ( huffman_round_trip_(text), text )
+}
+
+TEST(tests_huffman, "Round trip of random data over several blocks.")
+{
+    std::mt19937 generator { 5 };
+    std::geometric_distribution<int> distribution { 0.05 };
+    std::string data;
+    for ( int i {0}; i < 300000; ++i ) data.push_back(static_cast<char>(distribution(generator) % 256));
+    ASSERT_TRUE( huffman_round_trip_(data, 65536) == data )
+}
@@ -0,0 +1,127 @@
+/*
+    Test of indexed serialization and parallel loading
+*/
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "..\lib\ts\suite.hpp"
+#include "..\..\include\avl.hpp"
+#include "..\..\include\indexed.hpp"
+
+
+ts::Suite tests_indexed { "Indexed parallel loading" };
+
+inline std::filesystem::path indexed_path_(const std::string& name)
+{
+    return std::filesystem::temp_directory_path() / ("tree_indexed_" + name);
+}
+
+inline std::unique_ptr<tree::Node<int>> indexed_sample_tree_(int count)
+{
+    tree::AVL<int> search_tree;
+    for ( int i {0}; i < count; ++i ) search_tree.add((i * 7919) % 100003 - 50000);
+    return std::move(search_tree.root());
+}
+
+TEST(tests_indexed, "Text file is the one serialize writes.")
+{
+    auto root { indexed_sample_tree_(3000) };
+    auto path { indexed_path_("text.tr") };
+    tree::serialize_indexed(root, path);
+    std::ostringstream expected;
+    tree::serialize(root, expected);
+    std::ifstream in { path, std::ios::binary };
+    std::ostringstream written;
+    written << in.rdbuf();
+    ASSERT_TRUE( (written.str() == expected.str()) )
+    ASSERT_TRUE( std::filesystem::exists(path.string() + ".idx") )
+}
+
+TEST(tests_indexed, "Round trip for any cut level and number of threads.")
+{
+    auto root { indexed_sample_tree_(3000) };
+    auto path { indexed_path_("round_trip.tr") };
+    for ( size_t cut : {0, 1, 3, 6, 14} )
+    {
+        tree::serialize_indexed(root, path, cut);
+        for ( size_t threads : {1, 2, 8} )
+            ASSERT_TRUE( tree::compare(tree::load_tree_parallel<int>(path, threads), root) )
+    }
+}
+
+TEST(tests_indexed, "Empty, small and degenerate trees.")
+{
+    auto path { indexed_path_("shapes.tr") };
+    std::unique_ptr<tree::Node<int>> empty;
+    tree::serialize_indexed(empty, path);
+    ASSERT_FALSE( tree::load_tree_parallel<int>(path) )
+
+    auto single { std::make_unique<tree::Node<int>>(5) };
+    tree::serialize_indexed(single, path);
+    ASSERT_TRUE( tree::compare(tree::load_tree_parallel<int>(path), single) )
+
+    // A right spine: one subtree under the cut, every other index entry empty.
+    auto spine { std::make_unique<tree::Node<int>>(0) };
+    tree::Node<int>* last { spine.get() };
+    for ( int i {1}; i < 100; ++i ) last = last->right(i).get();
+    tree::serialize_indexed(spine, path, 4);
+    ASSERT_TRUE( tree::compare(tree::load_tree_parallel<int>(path, 4), spine) )
+}
+
+TEST(tests_indexed, "Falls back to load_tree without a valid index.")
+{
+    auto root { indexed_sample_tree_(500) };
+    auto path { indexed_path_("fallback.tr") };
+    tree::serialize_indexed(root, path);
+    std::filesystem::remove(path.string() + ".idx");
+    ASSERT_TRUE( tree::compare(tree::load_tree_parallel<int>(path), root) )
+
+    // The index of a different tree doesn't match the size of the file.
+    auto other { indexed_sample_tree_(400) };
+    tree::serialize_indexed(other, path);
+    std::ofstream { path, std::ios::binary | std::ios::trunc } << [&]{ std::ostringstream text; tree::serialize(root, text); return text.str(); }();
+    ASSERT_TRUE( tree::compare(tree::load_tree_parallel<int>(path), root) )
+}
+
+TEST(tests_indexed, "Edits that keep the size of the file are loaded as written.")
+{
+    // 1 2 # # 3 # #
+    auto root { std::make_unique<tree::Node<int>>(1) };
+    root->left(2);
+    root->right(3);
+    auto path { indexed_path_("same_size.tr") };
+    for ( const char* edited : { "1 2 # # 4 # # ", "7 2 # # 3 # # ", "1 # 2 # 3 # # ", "1 2 # 3 # # # " } )
+    {
+        tree::serialize_indexed(root, path, 1);
+        std::ofstream { path, std::ios::binary | std::ios::trunc } << edited;
+        auto expected { tree::load_tree<int>(path) };
+        for ( size_t threads : {1, 2} )
+            ASSERT_TRUE( tree::compare(tree::load_tree_parallel<int>(path, threads), expected) )
+    }
+}
+
+// Whether loading path in parallel throws std::runtime_error.
+inline bool indexed_throws_(const std::filesystem::path& path)
+{
+    try { tree::load_tree_parallel<int>(path, 2); }
+    catch ( const std::runtime_error& ) { return true; }
+    return false;
+}
+
+TEST(tests_indexed, "Corrupted subtrees throw.")
+{
+    auto root { indexed_sample_tree_(500) };
+    auto path { indexed_path_("corrupted.tr") };
+    tree::serialize_indexed(root, path, 2);
+    std::fstream file { path, std::ios::binary | std::ios::in | std::ios::out };
+    file.seekp(-6, std::ios::end);
+    file << "x";
+    file.close();
+    ASSERT_TRUE( indexed_throws_(path) )
+}
@@ -0,0 +1,80 @@
+/*
+    Test of interval tree
+*/
+#pragma once
+
+#include <random>
+#include <vector>
+
+#include "..\lib\ts\suite.hpp"
+#include "..\..\include\interval.hpp"
+
+
+ts::Suite tests_interval { "Interval tree" };
+
+using Interval_ = tree::Interval<int, int>;
+
+// Intervals of the list overlapping [a, b], ordered as the tree reports them.
+std::vector<Interval_> overlapping_scan_(std::vector<Interval_> intervals, int a, int b)
+{
+    std::vector<Interval_> result;
+    for ( const auto& interval : intervals )
+        if ( interval.lo <= b && a <= interval.hi ) result.push_back(interval);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+TEST(tests_interval, "Overlap queries agree with a linear scan.")
+{
+    std::mt19937 generator { 41 };
+    std::uniform_int_distribution<int> start { 0, 10000 };
+    std::uniform_int_distribution<int> length { 0, 200 };
+    std::vector<Interval_> intervals;
+    tree::IntervalTree<int, int> schedule;
+    for ( int i {0}; i < 2000; ++i )
+    {
+        int lo { start(generator) };
+        Interval_ interval { lo, lo + length(generator), i };
+        intervals.push_back(interval);
+        schedule.insert(interval);
+    }
+    for ( int i {0}; i < 500; ++i )
+    {
+        Interval_ interval { intervals.back() };
+        intervals.pop_back();
+        ASSERT_TRUE( schedule.erase(interval.lo, interval.hi) )
+    }
+    ASSERT_EQ( schedule.size(), 1500 )
+    ASSERT_TRUE( tree::is_balanced(schedule.root()) )
+    for ( int i {0}; i < 200; ++i )
+    {
+        int a { start(generator) };
+        int b { a + length(generator) };
+        auto found { schedule.overlapping(a, b) };
+        auto expected { overlapping_scan_(intervals, a, b) };
+        ASSERT_EQ( found.size(), expected.size() )
+        for ( size_t j {0}; j < found.size(); ++j ) ASSERT_TRUE( (found[j] == expected[j]) )
+    }
+}
+
+TEST(tests_interval, "Stabbing query finds intervals containing the point.")
+{
+    tree::IntervalTree<int, int> schedule { { {1, 5, 0}, {4, 8, 1}, {6, 7, 2}, {9, 9, 3} } };
+    auto found { schedule.stabbing(5) };
+    ASSERT_EQ( found.size(), 2 )
+    ASSERT_EQ( found[0].value, 0 )
+    ASSERT_EQ( found[1].value, 1 )
+    ASSERT_EQ( schedule.stabbing(9).size(), 1 )
+    ASSERT_TRUE( schedule.stabbing(0).empty() )
+    ASSERT_EQ( *schedule.max_end(), 9 )
+}
+
+TEST(tests_interval, "Query stops when the callback says so.")
+{
+    tree::IntervalTree<int, int> schedule;
+    for ( int i {0}; i < 100; ++i ) schedule.insert(i, i + 10, i);
+    int visited { 0 };
+    schedule.overlapping(0, 100, [&](const Interval_&){ return ++visited == 3 ? tree::Visit::stop : tree::Visit::proceed; });
+    ASSERT_EQ( visited, 3 )
+    ASSERT_FALSE( schedule.erase(1000, 1001) )
+}
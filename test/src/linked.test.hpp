@@ -116,3 +116,16 @@ TEST(tests_BT, "Add children.")
     root.left(std::move(left));
     root.right(std::move(right));
 }
+
+/*
+    Teardown
+*/
+TEST(tests_BT, "Freeing degenerate tree with 1M levels doesn't overflow the stack.")
+{
+    auto root { std::make_unique<tree::Node<int>>(0) };
+    tree::Node<int>* it { root.get() };
+    for ( int i {1}; i < 1'000'000; ++i )
+        it = ( i % 3 ? it->right(i) : it->left(i) ).get();   // Zig-zag, so both children get unlinked.
+    root.reset();
+    ASSERT_FALSE( root )
+}
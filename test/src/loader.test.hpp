@@ -0,0 +1,86 @@
+/*
+    Test of pipelined tree loader
+*/
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "..\lib\ts\suite.hpp"
+#include "..\..\include\avl.hpp"
+#include "..\..\include\loader.hpp"
+#include "..\..\include\succinct.hpp"
+
+
+ts::Suite tests_loader { "Pipelined tree loader" };
+
+inline std::filesystem::path loader_file_(const std::string& name, const std::string& contents)
+{
+    std::filesystem::path path { std::filesystem::temp_directory_path() / ("tree_loader_" + name) };
+    std::ofstream { path, std::ios::binary } << contents;
+    return path;
+}
+
+inline std::unique_ptr<tree::Node<int>> loader_sample_tree_()
+{
+    tree::AVL<int> search_tree;
+    for ( int i {0}; i < 3000; ++i ) search_tree.add((i * 7919) % 100003 - 50000);
+    return std::move(search_tree.root());
+}
+
+TEST(tests_loader, "Loads what serialize writes, as deserialize does.")
+{
+    auto root { loader_sample_tree_() };
+    std::ostringstream text;
+    tree::serialize(root, text);
+    auto path { loader_file_("serialized.tr", text.str()) };
+    ASSERT_TRUE( tree::compare(tree::load_tree<int>(path), root) )
+    std::ifstream in { path };
+    ASSERT_TRUE( tree::compare(tree::load_tree<int>(path), tree::deserialize<int>(in)) )
+}
+
+TEST(tests_loader, "Tokens cut by buffer ends and small batches.")
+{
+    auto root { loader_sample_tree_() };
+    std::ostringstream text;
+    tree::serialize(root, text);
+    auto path { loader_file_("small_buffers.tr", text.str()) };
+    for ( size_t buffer : {64, 65, 100, 4096} )
+        ASSERT_TRUE( tree::compare(tree::load_tree<int>(path, { buffer, 3 }), root) )
+    auto spaced { loader_file_("spaced.tr", "1\n2  #\t#\r\n3 # #   \n") };
+    auto loaded { tree::load_tree<int>(spaced, { 64, 1 }) };
+    ASSERT_EQ( loaded->data, 1 )
+    ASSERT_EQ( loaded->left()->data, 2 )
+    ASSERT_EQ( loaded->right()->data, 3 )
+    ASSERT_FALSE( tree::load_tree<int>(loader_file_("empty_tree.tr", "# ")) )
+}
+
+TEST(tests_loader, "Succinct files are recognized.")
+{
+    auto root { loader_sample_tree_() };
+    tree::SuccinctTree<int> compact { root };
+    std::ostringstream binary;
+    compact.save(binary);
+    auto path { loader_file_("succinct.sbt", binary.str()) };
+    ASSERT_TRUE( tree::compare(tree::load_tree<int>(path), root) )
+}
+
+// Whether loading path throws std::runtime_error.
+inline bool loader_throws_(const std::filesystem::path& path)
+{
+    try { tree::load_tree<int>(path); }
+    catch ( const std::runtime_error& ) { return true; }
+    return false;
+}
+
+TEST(tests_loader, "Invalid and truncated files throw.")
+{
+    ASSERT_TRUE( loader_throws_(loader_file_("invalid.tr", "1 2 x # #")) )
+    ASSERT_TRUE( loader_throws_(loader_file_("truncated.tr", "1 2 # # 3")) )
+    ASSERT_TRUE( loader_throws_(loader_file_("blank.tr", "")) )
+    ASSERT_TRUE( loader_throws_(std::filesystem::temp_directory_path() / "tree_loader_missing.tr") )
+}
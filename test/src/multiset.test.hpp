@@ -0,0 +1,69 @@
+/*
+    Test of multiset with counted nodes
+*/
+#pragma once
+
+#include <vector>
+
+#include "..\lib\ts\suite.hpp"
+#include "..\..\include\multiset.hpp"
+#include "..\..\include\types.hpp"
+
+
+ts::Suite tests_multiset { "Multiset with counted nodes" };
+
+struct Same_Record_
+{
+    bool operator()(const My_Data& lhs, const My_Data& rhs) const { return lhs.key == rhs.key && lhs.name == rhs.name; }
+};
+
+TEST(tests_multiset, "Duplicates share one node.")
+{
+    tree::Multiset<int> counters;
+    for ( int i {0}; i < 1000; ++i ) counters.add(i % 10);
+    ASSERT_EQ( counters.size(), 1000 )
+    ASSERT_EQ( counters.distinct(), 10 )
+    ASSERT_EQ( counters.count(3), 100 )
+    ASSERT_EQ( counters.count(11), 0 )
+    ASSERT_TRUE( counters.height() <= 4 )
+}
+
+TEST(tests_multiset, "Iteration yields every element in order.")
+{
+    tree::Multiset<int> counters { std::vector<int>({5, 1, 5, 3, 1, 5}) };
+    std::vector<int> keys(counters.begin(), counters.end());
+    ASSERT_TRUE( (keys == std::vector<int>({1, 1, 3, 5, 5, 5})) )
+}
+
+TEST(tests_multiset, "Removing duplicates changes count, the last one removes the node.")
+{
+    tree::Multiset<int> counters { std::vector<int>({2, 2, 4}) };
+    ASSERT_TRUE( counters.remove(2) )
+    ASSERT_EQ( counters.count(2), 1 )
+    ASSERT_EQ( counters.distinct(), 2 )
+    ASSERT_TRUE( counters.remove(2) )
+    ASSERT_FALSE( counters.contains(2) )
+    ASSERT_FALSE( counters.remove(2) )
+    ASSERT_EQ( counters.distinct(), 1 )
+    ASSERT_EQ( counters.size(), 1 )
+}
+
+TEST(tests_multiset, "Equal records that aren't the same go to the bucket.")
+{
+    tree::Multiset<My_Data, Same_Record_> records;
+    records.add(My_Data(1, "one"));
+    records.add(My_Data(1, "uno"));
+    records.add(My_Data(1, "one"));
+    records.add(My_Data(0, "zero"));
+    ASSERT_EQ( records.distinct(), 2 )
+    ASSERT_EQ( records.count(My_Data(1, "")), 3 )
+    std::vector<std::string> names;
+    for ( const My_Data& record : records ) names.push_back(record.name);
+    ASSERT_TRUE( (names == std::vector<std::string>({"zero", "one", "one", "uno"})) )
+
+    ASSERT_FALSE( records.remove(My_Data(1, "eins")) )
+    ASSERT_TRUE( records.remove(My_Data(1, "one")) )
+    ASSERT_TRUE( records.remove(My_Data(1, "one")) )        // Promotes "uno".
+    ASSERT_EQ( records.count(My_Data(1, "")), 1 )
+    ASSERT_EQ( (*++records.begin()).name, "uno" )
+}
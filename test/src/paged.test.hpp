@@ -0,0 +1,93 @@
+/*
+    Test of disk-backed AVL with a buffer pool
+*/
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <set>
+#include <vector>
+
+#include "..\lib\ts\suite.hpp"
+#include "..\..\include\paged.hpp"
+
+
+ts::Suite tests_paged { "Disk-backed AVL" };
+
+inline std::filesystem::path paged_path_(const std::string& name)
+{
+    std::filesystem::path path { std::filesystem::temp_directory_path() / ("tree_paged_" + name + ".pages") };
+    std::filesystem::remove(path);
+    return path;
+}
+
+TEST(tests_paged, "Add, search and remove match std::multiset with a small cache.")
+{
+    tree::PagedAVL<int> index { paged_path_("model"), 4 * 4096 };
+    std::multiset<int> model;
+    std::uint64_t state { 7 };
+    bool same { true };
+    for ( int i {0}; i < 20000; ++i )
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        int key { static_cast<int>((state >> 33) % 3000) };
+        if ( (state >> 20) % 3 )
+        {
+            index.add(key);
+            model.insert(key);
+        }
+        else
+        {
+            bool expected { model.count(key) > 0 };
+            if ( expected ) model.erase(model.find(key));
+            same = same && index.remove(key) == expected;
+        }
+    }
+    ASSERT_TRUE( same )
+    ASSERT_EQ( index.size(), model.size() )
+    ASSERT_TRUE( (index.range(0, 3000) == std::vector<int>(model.begin(), model.end())) )
+    ASSERT_TRUE( index.height() <= 18 )
+    ASSERT_TRUE( index.stats().evictions > 0 )
+}
+
+TEST(tests_paged, "Range visits keys of [lo, hi] in order and stops on request.")
+{
+    tree::PagedAVL<std::int64_t> index { paged_path_("range") };
+    for ( std::int64_t key {0}; key < 1000; ++key ) index.add(key * 2);
+    ASSERT_TRUE( (index.range(11, 19) == std::vector<std::int64_t>({12, 14, 16, 18})) )
+    ASSERT_TRUE( index.range(2001, 3000).empty() )
+    std::vector<std::int64_t> keys;
+    index.in_order([&](std::int64_t key){ keys.push_back(key); return keys.size() < 3 ? tree::Visit::proceed : tree::Visit::stop; });
+    ASSERT_TRUE( (keys == std::vector<std::int64_t>({0, 2, 4})) )
+    ASSERT_TRUE( index.contains(1998) )
+    ASSERT_FALSE( index.contains(1999) )
+}
+
+TEST(tests_paged, "Tree reopens from its file and reuses removed records.")
+{
+    auto path { paged_path_("reopen") };
+    size_t pages { 0 };
+    {
+        tree::PagedAVL<int> index { path };
+        for ( int key {0}; key < 5000; ++key ) index.add(key);
+        for ( int key {0}; key < 5000; key += 2 ) index.remove(key);
+        pages = index.pages();
+    }
+    tree::PagedAVL<int> index { path };
+    ASSERT_EQ( index.size(), 2500 )
+    ASSERT_TRUE( index.contains(4999) )
+    ASSERT_FALSE( index.contains(4998) )
+    for ( int key {0}; key < 5000; key += 2 ) index.add(key);
+    ASSERT_EQ( index.pages(), pages )
+    ASSERT_EQ( index.range(0, 5000).size(), 5000 )
+}
+
+TEST(tests_paged, "Cache that holds the whole tree only misses once per page.")
+{
+    tree::PagedAVL<int> index { paged_path_("cache"), 1 << 20 };
+    for ( int key {0}; key < 10000; ++key ) index.add(key);
+    index.reset_stats();
+    for ( int key {0}; key < 10000; ++key ) index.contains(key);
+    ASSERT_EQ( index.stats().reads, 0 )
+    ASSERT_TRUE( index.stats().hit_ratio() == 1.0 )
+}
@@ -0,0 +1,87 @@
+/*
+    Test of implicit-key AVL sequence
+*/
+#pragma once
+
+#include <random>
+#include <vector>
+
+#include "..\lib\ts\suite.hpp"
+#include "..\..\include\sequence.hpp"
+
+
+ts::Suite tests_sequence { "Sequence" };
+
+template<typename T>
+std::vector<T> sequence_values_(tree::Sequence<T>& sequence)
+{
+    return std::vector<T>(sequence.begin(), sequence.end());
+}
+
+TEST(tests_sequence, "Positional edits agree with std::vector.")
+{
+    std::mt19937 generator { 42 };
+    tree::Sequence<int> sequence;
+    std::vector<int> reference;
+    for ( int i {0}; i < 3000; ++i )
+    {
+        size_t position { std::uniform_int_distribution<size_t>{0, reference.size()}(generator) };
+        if ( reference.empty() || i % 3 != 0 )
+        {
+            sequence.insert_at(position, i);
+            reference.insert(reference.begin() + position, i);
+        }
+        else
+        {
+            position = std::min(position, reference.size() - 1);
+            ASSERT_EQ( sequence.erase_at(position), reference[position] )
+            reference.erase(reference.begin() + position);
+        }
+    }
+    ASSERT_EQ( sequence.size(), reference.size() )
+    ASSERT_TRUE( (sequence_values_(sequence) == reference) )
+    ASSERT_EQ( sequence.at(100), reference[100] )
+    ASSERT_TRUE( tree::is_balanced(sequence.root()) )
+}
+
+TEST(tests_sequence, "Split and concat keep order and balance.")
+{
+    std::vector<int> values(1000);
+    std::iota(values.begin(), values.end(), 0);
+    tree::Sequence<int> sequence { values };
+    for ( size_t i : { size_t(0), size_t(1), size_t(333), size_t(999), size_t(1000) } )
+    {
+        auto tail { sequence.split_at(i) };
+        ASSERT_EQ( sequence.size(), i )
+        ASSERT_EQ( tail.size(), 1000 - i )
+        ASSERT_TRUE( tree::is_balanced(sequence.root()) )
+        ASSERT_TRUE( tree::is_balanced(tail.root()) )
+        sequence.concat(std::move(tail));
+        ASSERT_TRUE( tail.empty() )
+        ASSERT_TRUE( (sequence_values_(sequence) == values) )
+    }
+}
+
+TEST(tests_sequence, "Concatenating sequences of very different size stays balanced.")
+{
+    tree::Sequence<int> sequence;
+    for ( int i {0}; i < 5000; ++i ) sequence.push_back(i);
+    tree::Sequence<int> small { std::vector<int>({5000, 5001}) };
+    sequence.concat(std::move(small));
+    tree::Sequence<int> front { std::vector<int>({-1}) };
+    front.concat(std::move(sequence));
+    ASSERT_EQ( front.size(), 5003 )
+    ASSERT_EQ( front[0], -1 )
+    ASSERT_EQ( front[5002], 5001 )
+    ASSERT_TRUE( tree::is_balanced(front.root()) )
+}
+
+TEST(tests_sequence, "Position out of range throws.")
+{
+    tree::Sequence<int> sequence { std::vector<int>({1, 2}) };
+    bool thrown { false };
+    try { sequence.at(2); } catch ( const std::out_of_range& ) { thrown = true; }
+    ASSERT_TRUE( thrown )
+    sequence.insert_at(2, 3);
+    ASSERT_EQ( sequence.at(2), 3 )
+}
@@ -0,0 +1,63 @@
+/*
+    Test of sharded AVL
+*/
+#pragma once
+
+#include <thread>
+#include <vector>
+
+#include "..\lib\ts\suite.hpp"
+#include "..\..\include\sharded.hpp"
+
+
+ts::Suite tests_sharded { "Sharded AVL" };
+
+TEST(tests_sharded, "Keys spread over shards, point operations find them.")
+{
+    tree::ShardedAVL<int, 8> index;
+    for ( int i {0}; i < 1000; ++i ) index.add(i);
+    ASSERT_EQ( index.size(), 1000 )
+    for ( size_t count : index.shard_sizes() ) ASSERT_TRUE( count > 60 && count < 190 )
+    ASSERT_TRUE( index.contains(500) )
+    ASSERT_FALSE( index.contains(1000) )
+    ASSERT_TRUE( index.remove(500) )
+    ASSERT_FALSE( index.remove(500) )
+    ASSERT_FALSE( index.search(500).has_value() )
+    ASSERT_EQ( index.size(), 999 )
+}
+
+TEST(tests_sharded, "In-order traversal merges shards.")
+{
+    tree::ShardedAVL<int, 4> index { std::vector<int>({9, 3, 7, 1, 5, 3}) };
+    std::vector<int> keys;
+    index.in_order([&](int key){ keys.push_back(key); });
+    ASSERT_TRUE( (keys == std::vector<int>({1, 3, 3, 5, 7, 9})) )
+    keys.clear();
+    index.in_order([&](int key){ keys.push_back(key); return key < 5 ? tree::Visit::proceed : tree::Visit::stop; });
+    ASSERT_TRUE( (keys == std::vector<int>({1, 3, 3, 5})) )
+}
+
+TEST(tests_sharded, "Range query returns keys of [lo, hi] in order.")
+{
+    tree::ShardedAVL<int, 16> index;
+    for ( int i {0}; i < 200; i += 2 ) index.add(i);
+    ASSERT_TRUE( (index.range(15, 25) == std::vector<int>({16, 18, 20, 22, 24})) )
+    ASSERT_TRUE( (index.range(16, 16) == std::vector<int>({16})) )
+    ASSERT_TRUE( index.range(17, 17).empty() )
+    ASSERT_TRUE( index.range(300, 400).empty() )
+    ASSERT_EQ( index.range(-10, 1000).size(), 100 )
+}
+
+TEST(tests_sharded, "Concurrent writers lose no keys.")
+{
+    tree::ShardedAVL<int, 8> index;
+    std::vector<std::thread> writers;
+    for ( int t {0}; t < 8; ++t )
+        writers.emplace_back([&index, t]{ for ( int i {t}; i < 8000; i += 8 ) index.add(i); });
+    for ( std::thread& writer : writers ) writer.join();
+    ASSERT_EQ( index.size(), 8000 )
+    std::vector<int> keys { index.range(0, 7999) };
+    bool in_order { true };
+    for ( size_t i {0}; i < keys.size(); ++i ) in_order = in_order && keys[i] == static_cast<int>(i);
+    ASSERT_TRUE( in_order )
+}
@@ -0,0 +1,87 @@
+/*
+    Test of k-ary SIMD search tree
+*/
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+
+#include "..\lib\ts\suite.hpp"
+#include "..\..\include\simd.hpp"
+#include "..\..\include\avl.hpp"
+
+
+ts::Suite tests_simd { "k-ary SIMD search tree" };
+
+template<typename K>
+void check_simd_tree_(const std::vector<K>& sorted, tree::Isa isa)
+{
+    tree::SimdSearchTree<K> simd_tree { sorted };
+    simd_tree.isa(isa);
+    std::mt19937 generator { 3 };
+    std::uniform_int_distribution<K> distribution { -10, static_cast<K>(3 * sorted.size() + 10) };
+    for ( int i {0}; i < 5000; ++i )
+    {
+        K key { distribution(generator) };
+        auto expected { std::lower_bound(sorted.begin(), sorted.end(), key) };
+        ASSERT_EQ( simd_tree.rank(key), static_cast<size_t>(expected - sorted.begin()) )
+        ASSERT_EQ( simd_tree.contains(key), (expected != sorted.end() && *expected == key) )
+        auto result { simd_tree.lower_bound(key) };
+        ASSERT_EQ( result.has_value(), (expected != sorted.end()) )
+        auto upper { std::upper_bound(sorted.begin(), sorted.end(), key) };
+        ASSERT_TRUE( (simd_tree.successor(key) == (upper == sorted.end() ? std::nullopt : std::optional<K>(*upper))) )
+        ASSERT_TRUE( (simd_tree.floor(key) == (upper == sorted.begin() ? std::nullopt : std::optional<K>(*(upper - 1)))) )
+        ASSERT_TRUE( (simd_tree.predecessor(key) == (expected == sorted.begin() ? std::nullopt : std::optional<K>(*(expected - 1)))) )
+    }
+}
+
+template<typename K>
+std::vector<K> simd_keys_(size_t count)
+{
+    std::vector<K> sorted;
+    std::mt19937 generator { 11 };
+    for ( size_t i {0}; i < count; ++i ) sorted.push_back(static_cast<K>(generator() % (3 * count + 1)));
+    std::sort(sorted.begin(), sorted.end());
+    return sorted;
+}
+
+TEST(tests_simd, "Rank and lower bound of 32-bit keys on every instruction set.")
+{
+    for ( size_t count : {0, 1, 15, 16, 17, 300, 4913, 100000} )
+    {
+        auto sorted { simd_keys_<std::int32_t>(count) };
+        for ( auto isa : {tree::Isa::scalar, tree::Isa::sse, tree::Isa::avx2} )
+            check_simd_tree_(sorted, isa);
+    }
+}
+
+TEST(tests_simd, "Rank and lower bound of 64-bit keys on every instruction set.")
+{
+    for ( size_t count : {0, 1, 7, 8, 9, 81, 1000, 100000} )
+    {
+        auto sorted { simd_keys_<std::int64_t>(count) };
+        for ( auto isa : {tree::Isa::scalar, tree::Isa::sse, tree::Isa::avx2} )
+            check_simd_tree_(sorted, isa);
+    }
+}
+
+TEST(tests_simd, "Extreme keys are found.")
+{
+    std::vector<int> sorted { INT_MIN, -1, 0, INT_MAX, INT_MAX };
+    tree::SimdSearchTree<int> simd_tree { sorted };
+    ASSERT_TRUE( simd_tree.contains(INT_MIN) )
+    ASSERT_TRUE( simd_tree.contains(INT_MAX) )
+    ASSERT_EQ( simd_tree.rank(INT_MAX), 3 )
+    ASSERT_FALSE( simd_tree.contains(1) )
+}
+
+TEST(tests_simd, "Build from AVL.")
+{
+    tree::AVL<int> search_tree { std::vector<int>({7, 2, 56, 8, 23, 3}) };
+    tree::SimdSearchTree<int> simd_tree { search_tree };
+    ASSERT_EQ( simd_tree.size(), 6 )
+    ASSERT_EQ( simd_tree.rank(8), 3 )
+    ASSERT_EQ( simd_tree.lower_bound(24).value(), 56 )
+}
@@ -0,0 +1,118 @@
+/*
+    Test of background snapshots
+*/
+#pragma once
+
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+#include "..\lib\ts\suite.hpp"
+#include "..\..\include\avl.hpp"
+#include "..\..\include\snapshot.hpp"
+
+
+ts::Suite tests_snapshot { "Background snapshots" };
+
+inline std::filesystem::path snapshot_path_(const std::string& name)
+{
+    return std::filesystem::temp_directory_path() / ("tree_snapshot_" + name + ".trc");
+}
+
+inline std::vector<int> loaded_keys_(const std::filesystem::path& path)
+{
+    tree::AVL<int> loaded;
+    tree::load_snapshot(loaded, path);
+    return std::vector<int>(loaded.begin(), loaded.end());
+}
+
+TEST(tests_snapshot, "Snapshot of a quiet tree holds every key.")
+{
+    tree::AVL<int> search_tree;
+    for ( int key {0}; key < 1000; ++key ) search_tree.add((key * 7919) % 1000);
+    tree::Snapshotting snapshots { search_tree };
+    auto path { snapshot_path_("quiet") };
+    ASSERT_EQ( snapshots.snapshot_to(path).get(), 1000 )
+    auto keys { loaded_keys_(path) };
+    bool in_order { keys.size() == 1000 };
+    for ( size_t i {0}; in_order && i < keys.size(); ++i ) in_order = keys[i] == static_cast<int>(i);
+    ASSERT_TRUE( in_order )
+}
+
+TEST(tests_snapshot, "Changes made after the mark are not in the snapshot.")
+{
+    tree::AVL<int> search_tree;
+    std::vector<int> expected;
+    for ( int key {0}; key < 20000; key += 2 )
+    {
+        search_tree.add(key);
+        expected.push_back(key);
+    }
+    tree::Snapshotting snapshots { search_tree };
+    auto path { snapshot_path_("changes") };
+    auto written { snapshots.snapshot_to(path) };
+    for ( int key {1}; key < 20000; key += 2 ) snapshots.add(key);
+    for ( int key {0}; key < 20000; key += 4 ) snapshots.remove(key);
+    snapshots.extract_max();
+    ASSERT_EQ( written.get(), 10000 )
+    ASSERT_TRUE( loaded_keys_(path) == expected )
+}
+
+TEST(tests_snapshot, "Duplicates keep their count at the mark.")
+{
+    tree::AVL<int> search_tree;
+    for ( int copy {0}; copy < 3; ++copy )
+        for ( int key {0}; key < 2000; ++key ) search_tree.add(key);
+    tree::Snapshotting snapshots { search_tree };
+    auto path { snapshot_path_("duplicates") };
+    std::thread writer { [&]{
+        for ( int key {0}; key < 2000; ++key )
+        {
+            snapshots.remove(key);
+            if ( key % 2 ) snapshots.remove(key);
+            else           snapshots.add(key);
+        }
+    } };
+    auto written { snapshots.snapshot_to(path) };
+    writer.join();
+    size_t count { written.get() };
+    auto keys { loaded_keys_(path) };
+    ASSERT_EQ( keys.size(), count )
+    // The mark fell somewhere in the writer's run: the snapshot is the tree after some prefix of its operations.
+    std::vector<int> copies(2000, 0);
+    for ( int key : keys ) ++copies[key];
+    std::vector<int> state(2000, 3);
+    int differ { 0 };
+    for ( int key {0}; key < 2000; ++key ) differ += copies[key] != state[key];
+    bool consistent { differ == 0 };
+    auto apply { [&](int key, int change){
+        differ -= copies[key] != state[key];
+        state[key] += change;
+        differ += copies[key] != state[key];
+        consistent = consistent || differ == 0;
+    } };
+    for ( int key {0}; key < 2000; ++key )
+    {
+        apply(key, -1);
+        apply(key, key % 2 ? -1 : 1);
+    }
+    ASSERT_TRUE( consistent )
+}
+
+TEST(tests_snapshot, "Keys removed ahead of the walk are in the snapshot.")
+{
+    tree::AVL<int> search_tree;
+    std::vector<int> expected;
+    for ( int key {0}; key < 100000; ++key )
+    {
+        search_tree.add(key);
+        expected.push_back(key);
+    }
+    tree::Snapshotting snapshots { search_tree };
+    auto path { snapshot_path_("removed_ahead") };
+    auto written { snapshots.snapshot_to(path) };
+    // The walk starts at the smallest key, the largest ones are removed before it gets to them.
+    for ( int key {99999}; key >= 90000; --key ) snapshots.remove(key);
+    ASSERT_EQ( written.get(), 100000 )
+    ASSERT_TRUE( loaded_keys_(path) == expected )
+}
@@ -0,0 +1,73 @@
+/*
+    Test of AVL with hot/cold split of keys and payloads
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "..\lib\ts\suite.hpp"
+#include "..\..\include\split.hpp"
+#include "..\..\include\types.hpp"
+
+
+ts::Suite tests_split { "Hot/cold split AVL" };
+
+struct My_Data_Key
+{
+    int operator()(const My_Data& data) const { return data.key; }
+};
+
+tree::SplitAVL<My_Data, My_Data_Key> set_up_split()
+{
+    tree::SplitAVL<My_Data, My_Data_Key> split_tree;
+    split_tree.add(My_Data(7, "seven"));
+    split_tree.add(My_Data(2, "two"));
+    split_tree.add(My_Data(56, "fifty six"));
+    split_tree.add(My_Data(8, "eight"));
+    split_tree.add(My_Data(23, "twenty three"));
+    split_tree.add(My_Data(3, "three"));
+    return split_tree;
+}
+
+TEST(tests_split, "Search by key returns the payload.")
+{
+    auto split_tree { set_up_split() };
+    ASSERT_EQ( split_tree.size(), 6 )
+    ASSERT_TRUE( split_tree.contains(23) )
+    ASSERT_EQ( split_tree.search(23).value().name, "twenty three" )
+    ASSERT_FALSE( split_tree.search(24).has_value() )
+}
+
+TEST(tests_split, "Iteration yields payloads ordered by key.")
+{
+    auto split_tree { set_up_split() };
+    std::vector<int> keys;
+    for ( const auto& data : split_tree ) keys.push_back(data.key);
+    ASSERT_TRUE( keys == std::vector<int>({2, 3, 7, 8, 23, 56}) )
+}
+
+TEST(tests_split, "Removing keys keeps order and reuses slots.")
+{
+    auto split_tree { set_up_split() };
+    ASSERT_TRUE( split_tree.remove(7) )
+    ASSERT_FALSE( split_tree.remove(7) )
+    ASSERT_FALSE( split_tree.contains(7) )
+    split_tree.add(My_Data(5, "five"));
+    std::vector<int> keys;
+    for ( auto it {split_tree.begin()}; it != split_tree.end(); ++it ) keys.push_back(it.key());
+    ASSERT_TRUE( keys == std::vector<int>({2, 3, 5, 8, 23, 56}) )
+    ASSERT_EQ( split_tree.search(5).value().name, "five" )
+}
+
+TEST(tests_split, "Tree stays balanced on sorted input.")
+{
+    tree::SplitAVL<int> split_tree;
+    for ( int i {0}; i < 1023; ++i ) split_tree.add(i);
+    ASSERT_EQ( split_tree.height(), 10 )
+    for ( int i {0}; i < 1023; i += 2 ) split_tree.remove(i);
+    ASSERT_EQ( split_tree.size(), 511 )
+    ASSERT_TRUE( split_tree.height() <= 13 )
+    ASSERT_EQ( split_tree.min().value(), 1 )
+    ASSERT_EQ( split_tree.max().value(), 1021 )
+}
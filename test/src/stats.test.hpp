@@ -0,0 +1,56 @@
+/*
+    Test of instrumentation of BST and AVL
+*/
+#pragma once
+
+#include "..\lib\ts\suite.hpp"
+#include "..\..\include\avl.hpp"
+
+
+ts::Suite tests_stats { "Instrumentation of BST and AVL" };
+
+TEST(tests_stats, "Uninstrumented tree takes no extra space and reports zeros.")
+{
+    ASSERT_EQ( sizeof(tree::BST<int>), sizeof(tree::BST<int, tree::CountingStats>) - sizeof(tree::Counters) )
+    tree::AVL<int> search_tree { std::vector<int>({1, 2, 3}) };
+    ASSERT_EQ( search_tree.stats().comparisons, 0 )
+    ASSERT_EQ( search_tree.stats().allocations, 0 )
+}
+
+TEST(tests_stats, "BST counts comparisons, allocations, frees and depth.")
+{
+    tree::BST<int, tree::CountingStats> search_tree;
+    for ( int key : {4, 2, 6, 1, 3} ) search_tree.add(key);
+    auto counters { search_tree.stats() };
+    ASSERT_EQ( counters.allocations, 5 )
+    ASSERT_EQ( counters.comparisons, 9 )    // 0 + 2 + 1 + 2 + (2 + 2): two checks of the cached ends, then descent
+    ASSERT_EQ( counters.max_depth, 3 )
+    ASSERT_EQ( counters.rotations, 0 )
+
+    search_tree.reset_stats();
+    search_tree.search(3);
+    ASSERT_EQ( search_tree.stats().comparisons, 3 )
+    search_tree.remove(2);
+    search_tree.extract_max();
+    ASSERT_EQ( search_tree.stats().frees, 2 )
+}
+
+TEST(tests_stats, "AVL counts rotations and balancing.")
+{
+    tree::AVL<int, tree::CountingStats> search_tree;
+    for ( int key : {1, 2, 3} ) search_tree.add(key);
+    auto counters { search_tree.stats() };
+    ASSERT_EQ( counters.rotations, 1 )
+    ASSERT_EQ( counters.balances, 3 )       // 0 + 1 + 2
+    ASSERT_EQ( counters.max_depth, 3 )
+
+    search_tree.reset_stats();
+    search_tree.add(0);
+    search_tree.add(-1);                    // Right rotation.
+    search_tree.add(4);
+    search_tree.add(5);                     // Left rotation.
+    search_tree.add(-3);
+    search_tree.add(-2);                    // Left-right rotation.
+    ASSERT_EQ( search_tree.stats().rotations, 4 )
+    ASSERT_TRUE( tree::is_balanced(search_tree.root()) )
+}
@@ -0,0 +1,147 @@
+/*
+    Test of succinct tree shape
+*/
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "..\lib\ts\suite.hpp"
+#include "..\..\include\linked.hpp"
+#include "..\..\include\succinct.hpp"
+
+
+ts::Suite tests_succinct { "Succinct tree shape" };
+
+// Random (not search) tree of count nodes with values 0 .. count - 1 in creation order.
+inline std::unique_ptr<tree::Node<int>> random_shape_(int count, std::uint64_t seed)
+{
+    auto root { std::make_unique<tree::Node<int>>(0) };
+    std::vector<tree::Node<int>*> open { root.get() };
+    for ( int value {1}; value < count; ++value )
+    {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        size_t index { static_cast<size_t>((seed >> 33) % open.size()) };
+        tree::Node<int>* node { open[index] };
+        bool go_left { ((seed >> 20) & 1) != 0 };
+        if ( node->left() ) go_left = false;
+        if ( node->right() ) go_left = true;
+        tree::Node<int>* child { (go_left ? node->left(value) : node->right(value)).get() };
+        if ( node->left() && node->right() )
+        {
+            open[index] = open.back();
+            open.pop_back();
+        }
+        open.push_back(child);
+    }
+    return root;
+}
+
+inline size_t pointer_subtree_size_(const tree::Node<int>* node)
+{
+    return node ? 1 + pointer_subtree_size_(node->left().get()) + pointer_subtree_size_(node->right().get()) : 0;
+}
+
+TEST(tests_succinct, "Rank and select agree with counting.")
+{
+    tree::RankSelect bits;
+    std::vector<size_t> ones;
+    for ( size_t i {0}; i < 5000; ++i )
+    {
+        bool bit { (i * 7919) % 13 < 5 };
+        bits.push_back(bit);
+        if ( bit ) ones.push_back(i);
+    }
+    bits.index();
+    ASSERT_EQ( bits.ones(), ones.size() )
+    bool same { true };
+    size_t count { 0 };
+    for ( size_t i {0}; i <= 5000; ++i )
+    {
+        same = same && bits.rank1(i) == count;
+        if ( i < 5000 ) count += bits[i];
+    }
+    for ( size_t j {1}; j <= ones.size(); ++j ) same = same && bits.select1(j) == ones[j - 1];
+    ASSERT_TRUE( same )
+}
+
+TEST(tests_succinct, "Navigation matches the pointer tree.")
+{
+    auto root { random_shape_(3000, 11) };
+    tree::SuccinctTree<int> compact { root };
+    ASSERT_EQ( compact.size(), 3000 )
+    ASSERT_EQ( compact.shape().size(), 6001 )
+    // Walk both trees in level order side by side.
+    std::queue<std::pair<const tree::Node<int>*, size_t>> nodes;
+    nodes.push({ root.get(), compact.root() });
+    bool same { true };
+    while ( !nodes.empty() )
+    {
+        auto [node, k] { nodes.front() };
+        nodes.pop();
+        same = same && compact[k] == node->data;
+        same = same && compact.is_leaf(k) == (node->degree() == tree::Degree::none);
+        same = same && compact.subtree_size(k) == pointer_subtree_size_(node);
+        for ( auto [child, c] : { std::pair{ node->left().get(), compact.left(k) }, std::pair{ node->right().get(), compact.right(k) } } )
+        {
+            same = same && static_cast<bool>(child) == (c != 0);
+            if ( !child || !c ) continue;
+            same = same && compact.parent(c) == k;
+            nodes.push({ child, c });
+        }
+    }
+    ASSERT_TRUE( same )
+    ASSERT_EQ( compact.parent(compact.root()), 0 )
+}
+
+TEST(tests_succinct, "Conversion to nodes and through a file is lossless.")
+{
+    auto root { random_shape_(1000, 5) };
+    tree::SuccinctTree<int> compact { root };
+    ASSERT_TRUE( tree::compare(compact.to_nodes(), root) )
+    std::stringstream file;
+    compact.save(file);
+    ASSERT_EQ( file.str().size(), 4 + 4 + 8 + 32 * 8 + 1000 * 4 )
+    auto loaded { tree::SuccinctTree<int>::load(file) };
+    ASSERT_TRUE( tree::compare(loaded.to_nodes(), root) )
+    ASSERT_EQ( loaded.subtree_size(1), 1000 )
+}
+
+// Whether loading a tree of ints as a tree of Ts throws std::runtime_error.
+template<typename T>
+bool succinct_load_throws_(const std::string& file)
+{
+    std::istringstream in { file };
+    try { tree::SuccinctTree<T>::load(in); }
+    catch ( const std::runtime_error& ) { return true; }
+    return false;
+}
+
+TEST(tests_succinct, "Files of other value sizes are rejected.")
+{
+    tree::SuccinctTree<int> compact { random_shape_(100, 9) };
+    std::ostringstream file;
+    compact.save(file);
+    ASSERT_FALSE( succinct_load_throws_<int>(file.str()) )
+    ASSERT_TRUE( succinct_load_throws_<long long>(file.str()) )
+    ASSERT_TRUE( succinct_load_throws_<short>(file.str()) )
+}
+
+TEST(tests_succinct, "Empty and single node trees.")
+{
+    tree::SuccinctTree<int> none { std::unique_ptr<tree::Node<int>>() };
+    ASSERT_TRUE( none.empty() )
+    ASSERT_EQ( none.root(), 0 )
+    ASSERT_FALSE( none.to_nodes() )
+    auto leaf { std::make_unique<tree::Node<int>>(42) };
+    tree::SuccinctTree<int> one { leaf };
+    ASSERT_EQ( one.left(1), 0 )
+    ASSERT_EQ( one.right(1), 0 )
+    ASSERT_EQ( one.subtree_size(1), 1 )
+    ASSERT_EQ( one[1], 42 )
+}
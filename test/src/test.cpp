@@ -2,8 +2,24 @@
 
 #include "_tests.hpp"
 
-int main()
+#include <string>
+
+/*
+    Usage: test [--threads N] [--output path]
+
+    Suites run on N threads (default 1). Results with timings are written as
+    CSV to path (default test_output.txt).
+*/
+int main(int argc, char* argv[])
 {
+    size_t threads { 1 };
+    std::string output { "test_output.txt" };
+    for ( int i {1}; i + 1 < argc; i += 2 )
+    {
+        std::string option { argv[i] };
+        if      ( option == "--threads" ) threads = std::stoul(argv[i + 1]);
+        else if ( option == "--output" )  output = argv[i + 1];
+    }
 
     ts::Tester tester { "Test suites of Binary Tree and its variants." };
     tester.add(tests_BT, "tests_BT");
@@ -14,7 +30,26 @@ int main()
     tester.add(tests_avl_constructor, "tests_avl_constructor");
     tester.add(tests_containers, "tests_containers");
     tester.add(tests_comparison, "tests_comparison");
-    tester.run();
+    tester.add(tests_split, "tests_split");
+    tester.add(tests_array, "tests_array");
+    tester.add(tests_simd, "tests_simd");
+    tester.add(tests_huffman, "tests_huffman");
+    tester.add(tests_stats, "tests_stats");
+    tester.add(tests_trace, "tests_trace");
+    tester.add(tests_generator, "tests_generator");
+    tester.add(tests_multiset, "tests_multiset");
+    tester.add(tests_augmented, "tests_augmented");
+    tester.add(tests_interval, "tests_interval");
+    tester.add(tests_sequence, "tests_sequence");
+    tester.add(tests_sharded, "tests_sharded");
+    tester.add(tests_durable, "tests_durable");
+    tester.add(tests_snapshot, "tests_snapshot");
+    tester.add(tests_paged, "tests_paged");
+    tester.add(tests_succinct, "tests_succinct");
+    tester.add(tests_loader, "tests_loader");
+    tester.add(tests_indexed, "tests_indexed");
+    tester.run(threads);
+    tester.write(output);
 
     return 0;
 }
@@ -0,0 +1,60 @@
+/*
+    Test of workload trace recording
+*/
+#pragma once
+
+#include <sstream>
+#include <vector>
+
+#include "..\lib\ts\suite.hpp"
+#include "..\..\include\avl.hpp"
+#include "..\..\include\trace.hpp"
+
+
+ts::Suite tests_trace { "Workload traces" };
+
+TEST(tests_trace, "Recorder forwards operations to the tree.")
+{
+    tree::AVL<int> search_tree;
+    std::ostringstream out;
+    tree::Recorder recorder { search_tree, out };
+    recorder.add(7);
+    recorder.add(3);
+    ASSERT_TRUE( recorder.search(7).has_value() )
+    ASSERT_TRUE( recorder.remove(3) )
+    ASSERT_EQ( recorder.extract_min().value(), 7 )
+    ASSERT_FALSE( search_tree.root() )
+}
+
+TEST(tests_trace, "Recorded trace reads back the same events.")
+{
+    tree::BST<int> search_tree;
+    std::stringstream trace;
+    {
+        tree::Recorder recorder { search_tree, trace };
+        for ( int key : {100, 101, 99, -2000000000, 2000000000} ) recorder.add(key);
+        recorder.search(99);
+        recorder.remove(101);
+        recorder.extract_max();
+        recorder.extract_min();
+    }
+    tree::TraceReader<int> reader { trace };
+    std::vector<tree::Op> ops;
+    std::vector<int> keys;
+    while ( auto event { reader.next() } )
+    {
+        ops.push_back(event->op);
+        if ( tree::has_key(event->op) ) keys.push_back(event->key);
+    }
+    ASSERT_EQ( ops.size(), 9 )
+    ASSERT_TRUE( ops[5] == tree::Op::search && ops[7] == tree::Op::extract_max )
+    ASSERT_TRUE( keys == std::vector<int>({100, 101, 99, -2000000000, 2000000000, 99, 101}) )
+}
+
+TEST(tests_trace, "Local keys take two bytes per record.")
+{
+    std::ostringstream out;
+    tree::TraceWriter<int> writer { out };
+    for ( int key {1000}; key < 2000; ++key ) writer.write(tree::Op::add, key);
+    ASSERT_TRUE( out.str().size() <= 5 + 3 + 2 * 999 )
+}